@@ -2,12 +2,41 @@
 #define BOARD_H
 
 #include <vector>
+#include <cstdint>
+#include <functional>
+#include <random>
 #include "IBoardSolver.h"
 
+class ReplayWriter;
+
 class Board : public IBoardSolver {
-    
+
+public:
+    static const int DEFAULT_GRID_SIZE = 9;
+    static const int DEFAULT_MINES = 10;
+
+    // Measured whenever the numbers are computed (all zero while mines are pending)
+    struct Difficulty {
+        int threeBV = 0;         // Minimum clicks to clear without flags
+        int openings = 0;        // Connected regions of zero cells
+        int isolatedNumbers = 0; // Numbers not bordering any opening, one click each
+    };
+
+    // A game generated ahead of time, swapped in whole by adoptGame() (see BoardPool)
+    struct Prepared {
+        std::uint64_t seed = 0;
+        int gridSize = 0;
+        int totalMines = 0;
+        bool minesPending = false;
+        Difficulty difficulty;
+        std::mt19937_64 rng; // mineRng as reset(seed) left it, so safe start draws the same cells
+        std::vector<std::vector<CellVal>> gridData;
+        std::vector<std::vector<bool>> revealedGrid;
+        std::vector<std::vector<bool>> flaggedGrid;
+    };
+
 private:
-    static const int GRID_SIZE = 9;
+    int gridSize = DEFAULT_GRID_SIZE;
     ClickMode currentClickMode = REVEAL;
     GameState currentGameState = PLAYING;
     std::vector<std::vector<CellVal>> gridData;
@@ -15,14 +44,46 @@ private:
     std::vector<std::vector<bool>> flaggedGrid;
     int selectedX = 0;
     int selectedY = 0;
-    int totalMines = 10;
-    
+    int totalMines = DEFAULT_MINES;
+    int revealedSafeCount = 0; // Non-mine cells revealed so far (drives the win check)
+    Difficulty difficulty;
+    // Scratch for measureDifficulty(), indexed on the framed flat grid
+    std::vector<std::uint8_t> flatCells;
+    std::vector<int> openingParent;
+    std::vector<std::uint8_t> nearOpening;
+
+    // First-click-safe mode: a seeded game waits for its first reveal, then places mines
+    // away from that cell and its neighbors and computes the numbers once
+    bool firstClickSafe = false;
+    bool minesPending = false;
+    int startCell = -1; // Where safe start opens when the layout names one (e.g. no-guess corpus boards)
+
+    // Change journal: cell indices whose player-visible state changed since the last reset.
+    // Consumers (e.g. the renderer's density pyramid) keep their own cursor into the log
+    // and rebuild from scratch whenever the epoch moves on.
+    std::vector<int> changeLog;
+    unsigned int changeEpoch = 0;
+
+    // Zobrist hash of the player view, updated on every visible change (see Zobrist.h)
+    std::uint64_t viewHash = 0;
+
+    // Every game is generated from a 64-bit seed so it can be replayed exactly
+    std::uint64_t gameSeed = 0;
+    std::mt19937_64 mineRng;
+    std::mt19937_64 seedRng; // Default seed source
+    std::function<std::uint64_t()> seedSource; // Overrides seedRng when set (e.g. batch runs)
+    std::function<bool(Board&)> layoutSource; // Supplies whole layouts via loadLayout(); false = fall back to seeds
+    ReplayWriter* recorder = nullptr;
+
 public:
-    Board();
-    
+    Board(int size = DEFAULT_GRID_SIZE, int mines = DEFAULT_MINES);
+
     // Grid properties
-    int getGridSize() const override { return GRID_SIZE; }
-    
+    int getGridSize() const override { return gridSize; }
+    int getTotalMines() const override { return totalMines; }
+    int getThreeBV() const override { return difficulty.threeBV; }
+    int cellIndex(int x, int y) const { return y * gridSize + x; }
+
     // Selection management
     int getSelectedX() const override { return selectedX; }
     int getSelectedY() const override { return selectedY; }
@@ -31,27 +92,55 @@ public:
     void moveUp();
     void moveDown();
     bool setSelectedCell(int x, int y) override;
-    
+
     // Game state
     GameState getGameState() const override { return currentGameState; }
     ClickMode getClickMode() const override { return currentClickMode; }
     void toggleClickMode();
     bool isGameOver() const override;
     void setClickMode(ClickMode mode) override;
-    
+
     // Cell queries
     int getCellVal(int x, int y) const override;
+    int getViewState(int x, int y) const override;
     bool isRevealed(int x, int y) const;
     bool isFlagged(int x, int y) const;
+    const Difficulty& getDifficulty() const { return difficulty; }
     bool searchCell(int x, int y) const override;
-    
+
+    // Seeds and recording
+    std::uint64_t getSeed() const { return gameSeed; }
+    void setSeedSource(std::function<std::uint64_t()> source) { seedSource = std::move(source); }
+    void setLayoutSource(std::function<bool(Board&)> source) { layoutSource = std::move(source); }
+    void setRecorder(ReplayWriter* writer); // Attach before the first move of a game
+
+    // Takes effect from the next seeded game; corpus layouts are always used as stored
+    void setFirstClickSafe(bool enabled) { firstClickSafe = enabled; }
+    bool isFirstClickSafe() const { return firstClickSafe; }
+    bool hasPendingMines() const { return minesPending; } // Layout still waits for the first reveal
+    void setStartCell(int index) { startCell = index; } // Cleared by every new game
+
+    // Change tracking
+    unsigned int getChangeEpoch() const override { return changeEpoch; }
+    const std::vector<int>& getChangeLog() const override { return changeLog; }
+    std::uint64_t getViewHash() const override { return viewHash; }
+
     // Game actions
     void revealCell(int x, int y);
     void handleClick(int x, int y);
     bool algoClick() override;
     void reset() override;
+    void reset(std::uint64_t seed);
+    void newGame(int size, int mines, std::uint64_t seed);
+    // Mine layouts as bitplanes, bit i of the plane = cellIndex i
+    void loadLayout(std::uint64_t seed, const std::uint64_t* mineBits);
+    void getMineBits(std::vector<std::uint64_t>& mineBits) const; // All clear while mines are pending
+    // Hands the freshly reset game over by swapping grids (this board then needs a reset)
+    void exportGame(Prepared& game);
+    // Swaps a prepared game in, as if reset(game.seed) had run; false if it doesn't fit this board
+    bool adoptGame(Prepared& game);
     void revealRandomZero() override;
-    
+
     // Utility
     std::vector<std::vector<int>> getPlayerView() const override;
     std::vector<std::pair<int, int>> getAllUnrevealedCells() const override;
@@ -59,13 +148,20 @@ public:
     std::vector<std::pair<int, int>> getUnrevealedNeighbors(int x, int y) const override;
     std::vector<std::pair<int, int>> getFlaggedNeighbors(int x, int y) const override;
     std::vector<std::pair<int, int>> getOnes() const override;
-    
+
 private:
-    void spawnMines();
+    void spawnMines(int safeX = -1, int safeY = -1);
     void solveForCellValues();
+    void measureDifficulty();
     bool isMine(int x, int y);
     void revealAllMines();
     void checkWinCondition();
+    void markChanged(int x, int y);
+    void hashCell(int x, int y);
+    void endGame(GameState state);
+    void clearForNewGame(std::uint64_t seed);
+    void startGame();
+    std::uint64_t nextSeed();
 };
 
 #endif
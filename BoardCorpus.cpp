@@ -0,0 +1,146 @@
+#include "BoardCorpus.h"
+#include "Board.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Creates the file at its final size with the header filled in, mapped for writing
+static uint8_t* createMapped(const string& path, int gridSize, int mines, uint64_t count, size_t& totalSize) {
+    size_t bytesPerRecord = boardCorpus::recordSize(gridSize);
+    totalSize = sizeof(boardCorpus::Header) + count * bytesPerRecord;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return nullptr;
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    void* mappedFile = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mappedFile == MAP_FAILED) return nullptr;
+    uint8_t* base = static_cast<uint8_t*>(mappedFile);
+
+    boardCorpus::Header header = {};
+    memcpy(header.magic, boardCorpus::MAGIC, 4);
+    header.version = boardCorpus::VERSION;
+    header.gridSize = static_cast<uint32_t>(gridSize);
+    header.mines = static_cast<uint32_t>(mines);
+    header.recordSize = static_cast<uint32_t>(bytesPerRecord);
+    header.count = count;
+    memcpy(base, &header, sizeof(header));
+    return base;
+}
+
+static bool finishMapped(uint8_t* base, size_t totalSize) {
+    bool synced = msync(base, totalSize, MS_SYNC) == 0;
+    munmap(base, totalSize);
+    return synced;
+}
+
+// Record i from the board's current layout
+static void writeRecord(uint8_t* base, uint64_t i, const Board& board, uint64_t seed, int startCell, const vector<uint64_t>& mineBits) {
+    const Board::Difficulty& difficulty = board.getDifficulty(); // Measured when the layout was generated
+    uint8_t* record = base + sizeof(boardCorpus::Header) + i * boardCorpus::recordSize(board.getGridSize());
+    boardCorpus::RecordHeader recordHeader = {};
+    recordHeader.seed = seed;
+    recordHeader.threeBV = static_cast<uint16_t>(min(difficulty.threeBV, 0xFFFF));
+    recordHeader.openings = static_cast<uint16_t>(min(difficulty.openings, 0xFFFF));
+    recordHeader.startCell = static_cast<uint32_t>(startCell + 1);
+    memcpy(record, &recordHeader, sizeof(recordHeader));
+    memcpy(record + sizeof(recordHeader), mineBits.data(), mineBits.size() * sizeof(uint64_t));
+}
+
+bool boardCorpus::generate(const string& path, int gridSize, int mines, uint64_t baseSeed, uint64_t count) {
+    size_t totalSize;
+    uint8_t* base = createMapped(path, gridSize, mines, count, totalSize);
+    if (!base) return false;
+
+    // Workers fill disjoint record ranges straight into the mapping
+    unsigned int threadCount = max(1u, thread::hardware_concurrency());
+    vector<thread> workers;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        uint64_t begin = count * t / threadCount;
+        uint64_t end = count * (t + 1) / threadCount;
+        workers.emplace_back([=]() {
+            Board board(gridSize, mines);
+            vector<uint64_t> mineBits;
+            for (uint64_t i = begin; i < end; i++) {
+                board.reset(baseSeed + i);
+                board.getMineBits(mineBits);
+                writeRecord(base, i, board, baseSeed + i, -1, mineBits);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return finishMapped(base, totalSize);
+}
+
+bool boardCorpus::write(const string& path, int gridSize, int mines, const vector<Layout>& layouts) {
+    size_t totalSize;
+    uint8_t* base = createMapped(path, gridSize, mines, layouts.size(), totalSize);
+    if (!base) return false;
+
+    Board board(gridSize, mines);
+    for (size_t i = 0; i < layouts.size(); i++) {
+        board.loadLayout(layouts[i].seed, layouts[i].mineBits.data());
+        writeRecord(base, i, board, layouts[i].seed, layouts[i].startCell, layouts[i].mineBits);
+    }
+    return finishMapped(base, totalSize);
+}
+
+// ---- CorpusReader ----
+
+CorpusReader::~CorpusReader() {
+    close();
+}
+
+bool CorpusReader::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(boardCorpus::Header)) {
+        ::close(fd);
+        return false;
+    }
+    void* mappedFile = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mappedFile == MAP_FAILED) return false;
+
+    mapped = static_cast<const uint8_t*>(mappedFile);
+    mappedSize = info.st_size;
+    header = reinterpret_cast<const boardCorpus::Header*>(mapped);
+
+    // Reject anything that isn't a complete corpus for this format
+    bool valid = memcmp(header->magic, boardCorpus::MAGIC, 4) == 0
+        && header->version == boardCorpus::VERSION
+        && header->recordSize == boardCorpus::recordSize(header->gridSize)
+        && sizeof(boardCorpus::Header) + header->count * header->recordSize <= mappedSize;
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    // Records are read front to back
+    madvise(const_cast<uint8_t*>(mapped), mappedSize, MADV_SEQUENTIAL);
+    return true;
+}
+
+void CorpusReader::close() {
+    if (mapped) munmap(const_cast<uint8_t*>(mapped), mappedSize);
+    mapped = nullptr;
+    mappedSize = 0;
+    header = nullptr;
+}
+
+void CorpusReader::loadInto(Board& board, uint64_t index) const {
+    board.loadLayout(record(index).seed, mineBits(index));
+    board.setStartCell(static_cast<int>(record(index).startCell) - 1);
+}
@@ -0,0 +1,93 @@
+#ifndef BOARDCORPUS_H
+#define BOARDCORPUS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Board;
+
+/**
+ * Fixed-record board corpus, meant to be generated once and memory-mapped by
+ * every experiment so all solver variants see the identical boards.
+ *
+ * File layout: Header, then `count` records of `recordSize` bytes each:
+ *   RecordHeader (seed + difficulty metadata), then the mine bitplane as
+ *   ceil(gridSize^2 / 64) little-endian 64-bit words (bit i = Board::cellIndex i).
+ * Boards are generated from their seed, so a corpus record can also be replayed by seed.
+ */
+namespace boardCorpus {
+    constexpr char MAGIC[4] = {'M', 'S', 'C', 'P'};
+    constexpr std::uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t gridSize;
+        std::uint32_t mines;
+        std::uint32_t recordSize;
+        std::uint32_t reserved;
+        std::uint64_t count;
+    };
+
+    struct RecordHeader {
+        std::uint64_t seed;
+        std::uint16_t threeBV;   // Minimum clicks to clear without flags
+        std::uint16_t openings;  // Connected regions of zero cells
+        std::uint32_t startCell; // Cell index + 1 to open first, 0 = any zero
+    };
+
+    // A board to store: its seed's layout plus where to open it
+    struct Layout {
+        std::uint64_t seed = 0;
+        int startCell = -1;
+        std::vector<std::uint64_t> mineBits;
+    };
+
+    inline std::size_t wordsPerBoard(int gridSize) { return (static_cast<std::size_t>(gridSize) * gridSize + 63) / 64; }
+    inline std::size_t recordSize(int gridSize) { return sizeof(RecordHeader) + wordsPerBoard(gridSize) * sizeof(std::uint64_t); }
+
+    // Generates `count` boards from consecutive seeds using every core; false on I/O failure
+    bool generate(const std::string& path, int gridSize, int mines, std::uint64_t baseSeed, std::uint64_t count);
+    // Writes the given layouts in order; false on I/O failure
+    bool write(const std::string& path, int gridSize, int mines, const std::vector<Layout>& layouts);
+}
+
+// Read-only memory-mapped view of a corpus file
+class CorpusReader {
+private:
+    const std::uint8_t* mapped = nullptr;
+    std::size_t mappedSize = 0;
+    const boardCorpus::Header* header = nullptr;
+
+public:
+    CorpusReader() = default;
+    ~CorpusReader();
+    CorpusReader(const CorpusReader&) = delete;
+    CorpusReader& operator=(const CorpusReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    std::uint64_t size() const { return header ? header->count : 0; }
+    int getGridSize() const { return static_cast<int>(header->gridSize); }
+    int getMines() const { return static_cast<int>(header->mines); }
+
+    const boardCorpus::RecordHeader& record(std::uint64_t index) const {
+        return *reinterpret_cast<const boardCorpus::RecordHeader*>(recordPtr(index));
+    }
+    const std::uint64_t* mineBits(std::uint64_t index) const {
+        return reinterpret_cast<const std::uint64_t*>(recordPtr(index) + sizeof(boardCorpus::RecordHeader));
+    }
+
+    // Loads record `index` into the board (board must match the corpus size), with its start cell
+    void loadInto(Board& board, std::uint64_t index) const;
+
+private:
+    const std::uint8_t* recordPtr(std::uint64_t index) const {
+        return mapped + sizeof(boardCorpus::Header) + index * header->recordSize;
+    }
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "BoardPool.h"
+
+using namespace std;
+
+BoardPool::BoardPool(int gridSize, int mines, bool firstClickSafe, function<uint64_t()> seeds, size_t capacity)
+    : gridSize(gridSize), mines(mines), firstClickSafe(firstClickSafe), seeds(std::move(seeds)) {
+    size_t size = 1;
+    while (size < max<size_t>(capacity, 1)) size <<= 1;
+    slots.resize(size);
+    mask = size - 1;
+    producer = thread(&BoardPool::produce, this);
+}
+
+BoardPool::~BoardPool() {
+    {
+        lock_guard<mutex> lock(parkMutex);
+        stopping.store(true);
+    }
+    slotFreed.notify_one();
+    producer.join();
+    if (attached) attached->setLayoutSource(nullptr);
+}
+
+void BoardPool::attach(Board& board) {
+    attached = &board;
+    board.setLayoutSource([this](Board& target) { return take(target); });
+}
+
+bool BoardPool::take(Board& board) {
+    if (board.getGridSize() != gridSize || board.getTotalMines() != mines || board.isFirstClickSafe() != firstClickSafe) return false;
+
+    uint64_t next = head.load(memory_order_relaxed);
+    if (tail.load(memory_order_acquire) == next) {
+        stalls++;
+        while (tail.load(memory_order_acquire) == next) {
+            if (stopping.load(memory_order_relaxed)) return false;
+            this_thread::yield();
+        }
+    }
+    bool adopted = board.adoptGame(slots[next & mask]);
+    {
+        // Under the lock so the wake-up can't slip between the producer's check and its wait
+        lock_guard<mutex> lock(parkMutex);
+        head.store(next + 1, memory_order_release); // The slot now holds the board's old grids
+    }
+    slotFreed.notify_one();
+    return adopted;
+}
+
+BoardPool::Stats BoardPool::getStats() const {
+    Stats stats;
+    stats.produced = tail.load();
+    stats.taken = head.load();
+    stats.stalls = stalls;
+    return stats;
+}
+
+void BoardPool::produce() {
+    Board generator(gridSize, mines);
+    generator.setFirstClickSafe(firstClickSafe);
+    while (!stopping.load(memory_order_relaxed)) {
+        uint64_t next = tail.load(memory_order_relaxed);
+        if (next - head.load(memory_order_acquire) > mask) {
+            // Full: sleep until the consumer takes a game
+            unique_lock<mutex> lock(parkMutex);
+            slotFreed.wait(lock, [&]() { return stopping.load() || next - head.load(memory_order_acquire) <= mask; });
+            continue;
+        }
+        generator.reset(seeds());
+        generator.exportGame(slots[next & mask]);
+        tail.store(next + 1, memory_order_release);
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef BOARDPOOL_H
+#define BOARDPOOL_H
+
+#include "Board.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Games generated ahead of time on a background thread, so Board::reset() only
+ * swaps grids instead of allocating, placing mines and computing numbers.
+ *
+ * A bounded single-producer/single-consumer ring: the producer owns the seed
+ * sequence and fills slots in order, the board's reset() takes them in order, so
+ * a pooled run plays exactly the games an unpooled one would. Head and tail are
+ * the only state the ring shares (no locks); a full ring parks the producer on a
+ * condition variable until take() frees a slot, so an idle GUI costs no wake-ups,
+ * and an empty one makes reset() wait for the next board rather than skip a seed.
+ *
+ * Games are prepared for one size, mine count and first-click-safe mode; a board
+ * that no longer matches (or a pool that is shut down) falls back to a normal reset.
+ */
+class BoardPool {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 16; // Rounded up to a power of two
+
+    struct Stats {
+        std::uint64_t produced = 0;
+        std::uint64_t taken = 0;
+        std::uint64_t stalls = 0; // Resets that had to wait for the producer
+    };
+
+private:
+    std::vector<Board::Prepared> slots;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::uint64_t> head{0}; // Next slot to take (consumer)
+    alignas(64) std::atomic<std::uint64_t> tail{0}; // Next slot to fill (producer)
+    std::atomic<bool> stopping{false};
+    std::mutex parkMutex; // Only for parking the producer while the ring is full
+    std::condition_variable slotFreed;
+    std::uint64_t stalls = 0;
+
+    int gridSize;
+    int mines;
+    bool firstClickSafe;
+    std::function<std::uint64_t()> seeds; // Only called on the producer thread
+    Board* attached = nullptr;
+    std::thread producer;
+
+public:
+    BoardPool(int gridSize, int mines, bool firstClickSafe, std::function<std::uint64_t()> seeds,
+              std::size_t capacity = DEFAULT_CAPACITY);
+    ~BoardPool();
+    BoardPool(const BoardPool&) = delete;
+    BoardPool& operator=(const BoardPool&) = delete;
+
+    // Makes the board's reset() take its games from this pool (detached again on destruction)
+    void attach(Board& board);
+    // Swaps the next game into the board; false if it doesn't fit
+    bool take(Board& board);
+
+    Stats getStats() const;
+
+private:
+    void produce();
+};
+
+#endif
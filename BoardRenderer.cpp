@@ -1,16 +1,35 @@
 #include "BoardRenderer.h"
+#include "GameStats.h"
 #include <SFML/Graphics.hpp>
 #include <cmath>
 #include <algorithm>
 
 BoardRenderer::BoardRenderer(Board& b, sf::RenderWindow& w) 
-    : board(&b), window(&w) {}
+    : board(&b), window(&w) {
+    // Start zoomed out far enough to show the whole board
+    viewSpan = std::max(board->getGridSize(), MIN_VISIBLE_CELLS) * CELL_SIZE;
+}
 
 void BoardRenderer::render() {
     if (!window) return;
     
     window->clear(sf::Color::White);
-    drawCells();
+    
+    // Board layer is drawn in world units through the zoomable board view
+    if (densityPyramid.sync(*board) && densityPyramid.wasRebuilt()) {
+        // Level widths follow the board size, which a new game may change
+        boardLod.level = -1;
+        minimapLod.level = -1;
+    }
+    updateBoardView();
+    window->setView(boardView);
+    
+    if (getPixelsPerCell() < LOD_MIN_CELL_PIXELS) {
+        drawDensityLayer();
+    } else {
+        boardLod.level = -1;
+        drawCells();
+    }
     
     // Check if click animation should still be shown
     if (showClickAnimation && clickAnimationClock.getElapsedTime().asSeconds() > (baseClickAnimationDuration / animationSpeed)) {
@@ -30,7 +49,12 @@ void BoardRenderer::render() {
         drawInspectionBox();
     }
     
+    window->setView(window->getDefaultView());
+    drawMinimap();
     drawModeIndicator();
+    
+    // Both LOD layers have consumed this frame's changes
+    densityPyramid.clearDirty();
 }
 
 void BoardRenderer::finishFrame() {
@@ -41,8 +65,14 @@ void BoardRenderer::finishFrame() {
 void BoardRenderer::drawCells() {
     int gridSize = board->getGridSize();
     
-    for (int i = 0; i < gridSize; i++) {
-        for (int j = 0; j < gridSize; j++) {
+    // Only draw the cells inside the current view
+    int firstX = std::max(0, static_cast<int>(viewLeft / CELL_SIZE));
+    int firstY = std::max(0, static_cast<int>(viewTop / CELL_SIZE));
+    int lastX = std::min(gridSize - 1, static_cast<int>((viewLeft + viewSpan) / CELL_SIZE));
+    int lastY = std::min(gridSize - 1, static_cast<int>((viewTop + viewSpan) / CELL_SIZE));
+    
+    for (int i = firstX; i <= lastX; i++) {
+        for (int j = firstY; j <= lastY; j++) {
             if (board->isRevealed(i, j)) {
                 drawRevealedCell(i, j);
             } else {
@@ -197,10 +227,10 @@ void BoardRenderer::drawNumber(int x, int y, int value) {
 void BoardRenderer::drawModeIndicator() {
     // Mode indicator panel at bottom
     float indicatorHeight = 30;
-    float boardHeight = board->getGridSize() * CELL_SIZE;
+    float boardHeight = BOARD_VIEW_PIXELS;
     float indicatorY = boardHeight;
     
-    sf::RectangleShape indicatorBg({board->getGridSize() * CELL_SIZE, indicatorHeight});
+    sf::RectangleShape indicatorBg({BOARD_VIEW_PIXELS, indicatorHeight});
     indicatorBg.setPosition({0, indicatorY});
     indicatorBg.setFillColor(sf::Color(220, 220, 220));
     window->draw(indicatorBg);
@@ -223,15 +253,15 @@ void BoardRenderer::drawModeIndicator() {
     sf::FloatRect textBounds = modeText.getLocalBounds();
     modeText.setOrigin({textBounds.size.x / 2 + textBounds.position.x, 
                        textBounds.size.y / 2 + textBounds.position.y});
-    modeText.setPosition({board->getGridSize() * CELL_SIZE / 2, indicatorY + indicatorHeight / 2});
+    modeText.setPosition({BOARD_VIEW_PIXELS / 2, indicatorY + indicatorHeight / 2});
     window->draw(modeText);
 }
 
 void BoardRenderer::drawGameOverScreen() {
     if (board->getGameState() == Board::PLAYING) return;
     
-    float boardWidth = board->getGridSize() * CELL_SIZE;
-    float boardHeight = board->getGridSize() * CELL_SIZE;
+    float boardWidth = BOARD_VIEW_PIXELS;
+    float boardHeight = BOARD_VIEW_PIXELS;
     
     // Semi-transparent overlay
     sf::RectangleShape overlay({boardWidth, boardHeight});
@@ -348,17 +378,18 @@ void BoardRenderer::startSelectionAnimation(int oldX, int oldY) {
     prevSelectedY = oldY;
     isAnimatingSelection = true;
     selectionAnimationClock.restart();
+    ensureCellVisible(board->getSelectedX(), board->getSelectedY());
 }
 
 void BoardRenderer::drawStatsAndControls(int wins, int losses, float speed, const std::string& solverName, bool solverActive,
-                                         const std::map<std::pair<int, int>, float>* heatmapData, bool safeStart) {
-    float boardWidth = board->getGridSize() * CELL_SIZE;
-    float boardHeight = board->getGridSize() * CELL_SIZE;
+                                         const std::map<std::pair<int, int>, float>* heatmapData, bool safeStart,
+                                         const GameStats* stats) {
+    float boardWidth = BOARD_VIEW_PIXELS;
     int totalGames = wins + losses;
     
     // Stats panel on the right side, outside the board
     float statsWidth = 200;
-    float statsHeight = 190;
+    float statsHeight = 245;
     float statsX = boardWidth + 10; // 10px padding from board edge
     float statsY = 10;
     
@@ -405,6 +436,22 @@ void BoardRenderer::drawStatsAndControls(int wins, int losses, float speed, cons
     statsText.setPosition({statsX + 10, statsY + 10});
     window->draw(statsText);
     
+    // Per-game averages and time quantiles from the solver's statistics
+    sf::Text metricsText(font);
+    metricsText.setCharacterSize(12);
+    metricsText.setFillColor(sf::Color(60, 60, 60));
+    std::string metricsStr = "Moves/game: -\nGuesses/game: -\nTime p50/p99: -";
+    if (stats && stats->getGames() > 0) {
+        double games = static_cast<double>(stats->getGames());
+        char metricsBuffer[128];
+        snprintf(metricsBuffer, sizeof(metricsBuffer), "Moves/game: %.1f\nGuesses/game: %.2f\nTime p50/p99: %.2fs / %.2fs",
+                 stats->getMoves() / games, stats->getGuesses() / games, stats->timeQuantile(0.5), stats->timeQuantile(0.99));
+        metricsStr = metricsBuffer;
+    }
+    metricsText.setString(metricsStr);
+    metricsText.setPosition({statsX + 10, statsY + 140});
+    window->draw(metricsText);
+    
     // Draw Start/Stop button (with extra padding above)
     buttonWidth = 180;
     buttonHeight = 35;
@@ -439,7 +486,7 @@ void BoardRenderer::drawStatsAndControls(int wins, int losses, float speed, cons
     
     // Controls panel on the right side, below stats
     float controlsWidth = 200;
-    float controlsHeight = 230;
+    float controlsHeight = 275;
     float controlsX = boardWidth + 10; // 10px padding from board edge
     float controlsY = statsY + statsHeight + 15; // 15px below stats panel
     
@@ -462,8 +509,11 @@ void BoardRenderer::drawStatsAndControls(int wins, int losses, float speed, cons
     controlsStr += "\nGame Controls:\n";
     controlsStr += "R - Reset\n";
     controlsStr += "X - Safe Start: " + std::string(safeStart ? "ON" : "OFF") + "\n";
+    controlsStr += "C - First Click Safe: " + std::string(board->isFirstClickSafe() ? "ON" : "OFF") + "\n";
     controlsStr += "Space - Mode\n";
     controlsStr += "+/- - Speed\n";
+    controlsStr += "Wheel - Zoom\n";
+    controlsStr += "V - Vsync\n";
     controlsStr += "F - Debug\n";  // Added newline for bottom padding
     controlsText.setString(controlsStr);
     controlsText.setPosition({controlsX + 10, controlsY + 10});
@@ -561,6 +611,17 @@ void BoardRenderer::drawHeatmap(float x, float y, float size, const std::map<std
     heatmapBg.setOutlineColor(sf::Color(100, 100, 100));
     window->draw(heatmapBg);
     
+    static sf::Font font("font.ttf");
+    
+    // Per-cell squares stop being readable (and cheap) once they shrink below a couple of pixels
+    if (miniCellSize < 2.0f) {
+        sf::Text noteText(font, "Board too large for heatmap", 12);
+        noteText.setFillColor(sf::Color(60, 60, 60));
+        noteText.setPosition({x + 10, y + size / 2 - 6});
+        window->draw(noteText);
+        return;
+    }
+    
     // Find max probability for normalization
     float maxProb = 0.0f;
     for (const auto& entry : heatmapData) {
@@ -605,11 +666,10 @@ void BoardRenderer::drawHeatmap(float x, float y, float size, const std::map<std
     }
     
     // Draw title
-    static sf::Font font("font.ttf");
     sf::Text titleText(font);
     titleText.setCharacterSize(12);
     titleText.setFillColor(sf::Color(30, 30, 30));
-    titleText.setString("Probability Heatmap");
+    titleText.setString(heatmapCaption);
     titleText.setPosition({x + 5, y - 18});
     window->draw(titleText);
 }
@@ -618,3 +678,170 @@ bool BoardRenderer::isStartStopButtonClicked(float mouseX, float mouseY) const {
     return mouseX >= buttonX && mouseX <= buttonX + buttonWidth &&
            mouseY >= buttonY && mouseY <= buttonY + buttonHeight;
 }
+
+void BoardRenderer::updateBoardView() {
+    float worldSize = getBoardWorldSize();
+    float maxSpan = std::max(worldSize, MIN_VISIBLE_CELLS * CELL_SIZE);
+    float minSpan = MIN_VISIBLE_CELLS * CELL_SIZE;
+    viewSpan = std::clamp(viewSpan, minSpan, maxSpan);
+    viewLeft = std::clamp(viewLeft, 0.0f, std::max(0.0f, worldSize - viewSpan));
+    viewTop = std::clamp(viewTop, 0.0f, std::max(0.0f, worldSize - viewSpan));
+    
+    // Map the visible world square onto the board area of the window
+    sf::Vector2u windowSize = window->getSize();
+    boardView = sf::View(sf::FloatRect({viewLeft, viewTop}, {viewSpan, viewSpan}));
+    boardView.setViewport(sf::FloatRect({0, 0}, {BOARD_VIEW_PIXELS / windowSize.x, BOARD_VIEW_PIXELS / windowSize.y}));
+}
+
+void BoardRenderer::zoomAt(float mouseX, float mouseY, float wheelDelta) {
+    if (mouseX < 0 || mouseX >= BOARD_VIEW_PIXELS || mouseY < 0 || mouseY >= BOARD_VIEW_PIXELS) return;
+    
+    // Keep the world point under the cursor fixed while zooming
+    float fracX = mouseX / BOARD_VIEW_PIXELS;
+    float fracY = mouseY / BOARD_VIEW_PIXELS;
+    float worldX = viewLeft + fracX * viewSpan;
+    float worldY = viewTop + fracY * viewSpan;
+    
+    float maxSpan = std::max(getBoardWorldSize(), MIN_VISIBLE_CELLS * CELL_SIZE);
+    viewSpan = std::clamp(viewSpan * std::pow(0.85f, wheelDelta), MIN_VISIBLE_CELLS * CELL_SIZE, maxSpan);
+    viewLeft = worldX - fracX * viewSpan;
+    viewTop = worldY - fracY * viewSpan;
+    updateBoardView();
+}
+
+void BoardRenderer::ensureCellVisible(int x, int y) {
+    float cellLeft = x * CELL_SIZE;
+    float cellTop = y * CELL_SIZE;
+    
+    // Recenter on the cell if it has left the view
+    if (cellLeft < viewLeft || cellLeft + CELL_SIZE > viewLeft + viewSpan) {
+        viewLeft = cellLeft + CELL_SIZE / 2 - viewSpan / 2;
+    }
+    if (cellTop < viewTop || cellTop + CELL_SIZE > viewTop + viewSpan) {
+        viewTop = cellTop + CELL_SIZE / 2 - viewSpan / 2;
+    }
+    updateBoardView();
+}
+
+bool BoardRenderer::pixelToCell(float mouseX, float mouseY, int& cellX, int& cellY) const {
+    if (mouseX < 0 || mouseX >= BOARD_VIEW_PIXELS || mouseY < 0 || mouseY >= BOARD_VIEW_PIXELS) return false;
+    
+    float worldX = viewLeft + mouseX / BOARD_VIEW_PIXELS * viewSpan;
+    float worldY = viewTop + mouseY / BOARD_VIEW_PIXELS * viewSpan;
+    cellX = static_cast<int>(worldX / CELL_SIZE);
+    cellY = static_cast<int>(worldY / CELL_SIZE);
+    return cellX >= 0 && cellX < board->getGridSize() && cellY >= 0 && cellY < board->getGridSize();
+}
+
+void BoardRenderer::refreshLodLayer(LodLayer& layer, int level) {
+    int width = densityPyramid.getLevelWidth(level);
+    bool rebuild = layer.level != level || layer.width != width;
+    
+    if (rebuild) {
+        layer.level = -1;
+        if (!layer.texture.resize({static_cast<unsigned int>(width), static_cast<unsigned int>(width)})) return;
+        layer.pixels.assign(static_cast<size_t>(width) * width * 4, 0);
+        layer.level = level;
+        layer.width = width;
+    }
+    
+    // Blend revealed / flagged / unknown fractions into one texel per tile
+    auto writeTexel = [&](int tileIndex) {
+        const DensityPyramid::Tile& tile = densityPyramid.getTile(level, tileIndex % width, tileIndex / width);
+        float cells = static_cast<float>(std::max<std::uint32_t>(tile.cells, 1));
+        float revealed = tile.revealed / cells;
+        float flagged = tile.flagged / cells;
+        float unknown = 1.0f - revealed - flagged;
+        std::uint8_t* texel = &layer.pixels[static_cast<size_t>(tileIndex) * 4];
+        texel[0] = static_cast<std::uint8_t>(215 * revealed + 220 * flagged + 90 * unknown);
+        texel[1] = static_cast<std::uint8_t>(215 * revealed + 20 * flagged + 90 * unknown);
+        texel[2] = static_cast<std::uint8_t>(215 * revealed + 20 * flagged + 90 * unknown);
+        texel[3] = 255;
+    };
+    
+    const std::vector<int>& dirtyTiles = densityPyramid.getDirtyTiles(level);
+    if (rebuild) {
+        for (int i = 0; i < width * width; i++) writeTexel(i);
+    } else if (!dirtyTiles.empty()) {
+        for (int tileIndex : dirtyTiles) writeTexel(tileIndex);
+    } else {
+        return; // Nothing changed since the last upload
+    }
+    layer.texture.update(layer.pixels.data(), {static_cast<unsigned int>(width), static_cast<unsigned int>(width)}, {0, 0});
+}
+
+// Levels round their width up, so when the grid side isn't a multiple of 2^level the last
+// texel column and row hold fewer cells; they are drawn only as wide as those cells
+void BoardRenderer::drawLodLayer(const LodLayer& layer, sf::Vector2f origin, float cellSize) {
+    if (layer.level < 0) return;
+    int span = 1 << layer.level; // Cells per side of a whole tile
+    int whole = board->getGridSize() / span;
+    int rest = board->getGridSize() - whole * span;
+    
+    // First texel, texel count, size per texel and offset of the whole tiles and of the edge tile
+    struct Strip {
+        int texel;
+        int texels;
+        float size;
+        float offset;
+    };
+    const Strip strips[2] = {{0, whole, span * cellSize, 0.0f}, {whole, rest > 0 ? 1 : 0, rest * cellSize, whole * span * cellSize}};
+    for (const Strip& column : strips) {
+        for (const Strip& row : strips) {
+            if (column.texels == 0 || row.texels == 0) continue;
+            sf::Sprite sprite(layer.texture);
+            sprite.setTextureRect(sf::IntRect({column.texel, row.texel}, {column.texels, row.texels}));
+            sprite.setPosition({origin.x + column.offset, origin.y + row.offset});
+            sprite.setScale({column.size, row.size});
+            window->draw(sprite);
+        }
+    }
+}
+
+void BoardRenderer::drawDensityLayer() {
+    // Coarsest level whose tiles are still at least one screen pixel
+    float pixelsPerCell = getPixelsPerCell();
+    int level = 0;
+    while (level + 1 < densityPyramid.getLevelCount() && (1 << level) * pixelsPerCell < 1.0f) {
+        level++;
+    }
+    refreshLodLayer(boardLod, level);
+    drawLodLayer(boardLod, {0, 0}, CELL_SIZE);
+}
+
+void BoardRenderer::drawMinimap() {
+    float worldSize = getBoardWorldSize();
+    if (viewSpan >= worldSize) {
+        minimapLod.level = -1; // Whole board visible, no inset needed
+        return;
+    }
+    
+    // First level small enough to fit the inset
+    int level = 0;
+    while (level + 1 < densityPyramid.getLevelCount() && densityPyramid.getLevelWidth(level) > MINIMAP_PIXELS) {
+        level++;
+    }
+    refreshLodLayer(minimapLod, level);
+    
+    float mapX = BOARD_VIEW_PIXELS - MINIMAP_PIXELS - 8;
+    float mapY = BOARD_VIEW_PIXELS - MINIMAP_PIXELS - 8;
+    
+    sf::RectangleShape frame({MINIMAP_PIXELS, MINIMAP_PIXELS});
+    frame.setPosition({mapX, mapY});
+    frame.setFillColor(sf::Color(240, 240, 240));
+    frame.setOutlineThickness(2);
+    frame.setOutlineColor(sf::Color(60, 60, 60));
+    window->draw(frame);
+    
+    drawLodLayer(minimapLod, {mapX, mapY}, MINIMAP_PIXELS / board->getGridSize());
+    
+    // Current viewport rectangle
+    float toMap = MINIMAP_PIXELS / worldSize;
+    float rectSize = std::min(viewSpan, worldSize) * toMap;
+    sf::RectangleShape viewportRect({rectSize, rectSize});
+    viewportRect.setPosition({mapX + viewLeft * toMap, mapY + viewTop * toMap});
+    viewportRect.setFillColor(sf::Color::Transparent);
+    viewportRect.setOutlineThickness(1);
+    viewportRect.setOutlineColor(sf::Color(255, 220, 0));
+    window->draw(viewportRect);
+}
@@ -3,14 +3,24 @@
 
 #include <SFML/Graphics.hpp>
 #include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
 #include "Board.h"
+#include "DensityPyramid.h"
+
+class GameStats;
 
 class BoardRenderer {
 public:
     enum SelectionType { SELECT, SEARCH, CLICK, GUESS };
     
 private:
-    static constexpr float CELL_SIZE = 50.0f;
+    static constexpr float CELL_SIZE = 50.0f; // World units per cell; the board view scales this to the screen
+    static constexpr float BOARD_VIEW_PIXELS = 450.0f; // On-screen size of the board area
+    static constexpr int MIN_VISIBLE_CELLS = 9; // Closest zoom shows this many cells across
+    static constexpr float LOD_MIN_CELL_PIXELS = 4.0f; // Below this cells are drawn from the density pyramid
+    static constexpr float MINIMAP_PIXELS = 100.0f;
     Board* board;
     sf::RenderWindow* window;
     sf::Clock clickAnimationClock;
@@ -19,6 +29,7 @@ private:
     bool debugOverlayEnabled = false;
     float animationSpeed = 1.0f; // Speed multiplier for all animations
     bool isGuessMove = false; // Track if current move is a random guess
+    std::string heatmapCaption = "Probability Heatmap";
     
     // Selection animation
     bool isAnimatingSelection = false;
@@ -33,6 +44,23 @@ private:
     int inspectY = -1;
     sf::Clock inspectionAnimationClock;
     
+    // Board view (zoom/pan), in world units
+    sf::View boardView;
+    float viewLeft = 0;
+    float viewTop = 0;
+    float viewSpan = 0;
+    
+    // Level-of-detail rendering for zoomed-out boards
+    struct LodLayer {
+        sf::Texture texture;
+        std::vector<std::uint8_t> pixels;
+        int level = -1; // Pyramid level currently uploaded (-1 = stale)
+        int width = 0;  // Texels per side of the uploaded level
+    };
+    DensityPyramid densityPyramid;
+    LodLayer boardLod;
+    LodLayer minimapLod;
+    
     // Start/Stop button bounds
     float buttonX = 0;
     float buttonY = 0;
@@ -53,15 +81,22 @@ public:
     void drawSelectionBox(SelectionType type);
     void drawStatsAndControls(int wins, int losses, float speed, const std::string& solverName, bool solverActive, 
                              const std::map<std::pair<int, int>, float>* heatmapData = nullptr,
-                             bool safeStart = false);
+                             bool safeStart = false, const GameStats* stats = nullptr);
     bool isStartStopButtonClicked(float mouseX, float mouseY) const;
     
+    // Board view control
+    void zoomAt(float mouseX, float mouseY, float wheelDelta);
+    void ensureCellVisible(int x, int y);
+    bool pixelToCell(float mouseX, float mouseY, int& cellX, int& cellY) const;
+    
     // Animation control
     void startClickAnimation();
     void startSelectionAnimation(int oldX, int oldY);
     void startInspection(int x, int y);
     void stopInspection();
     void setGuessMove(bool isGuess) { isGuessMove = isGuess; }
+    void setHeatmapCaption(const std::string& caption) { heatmapCaption = caption; }
+    bool isAnimating() const { return showClickAnimation || isAnimatingSelection || isInspecting; }
     
     // Debug features
     void setDebugOverlay(bool enabled) { debugOverlayEnabled = enabled; }
@@ -71,6 +106,7 @@ public:
     
     // Utility
     float getCellSize() const { return CELL_SIZE; }
+    float getBoardPixelSize() const { return BOARD_VIEW_PIXELS; }
     
 private:
     void drawRevealedCell(int x, int y);
@@ -81,6 +117,15 @@ private:
     void drawDebugOverlay(int x, int y);
     void drawInspectionBox();
     void drawHeatmap(float x, float y, float size, const std::map<std::pair<int, int>, float>& heatmapData);
+    
+    // Board view / level of detail
+    void updateBoardView();
+    float getBoardWorldSize() const { return board->getGridSize() * CELL_SIZE; }
+    float getPixelsPerCell() const { return BOARD_VIEW_PIXELS * CELL_SIZE / viewSpan; }
+    void drawDensityLayer();
+    void drawMinimap();
+    void refreshLodLayer(LodLayer& layer, int level);
+    void drawLodLayer(const LodLayer& layer, sf::Vector2f origin, float cellSize);
 };
 
 #endif
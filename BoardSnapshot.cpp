@@ -0,0 +1,175 @@
+#include "BoardSnapshot.h"
+#include "Zobrist.h"
+#include <algorithm>
+
+using namespace std;
+
+void BoardSnapshot::capture(const IBoardSolver& board) {
+    gridSize = board.getGridSize();
+    totalMines = board.getTotalMines();
+    cells.assign(gridSize * gridSize, UNKNOWN);
+    layout.clear();
+    journal.clear();
+    unknownCount = flagCount = safeRevealed = minesRevealed = 0;
+    hash = zobrist::boardKey(gridSize, totalMines);
+
+    vector<vector<int>> view = board.getPlayerView();
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
+            int8_t value = static_cast<int8_t>(view[x][y]);
+            cells[cellIndex(x, y)] = value;
+            adjustCounts(value, 1);
+            hash ^= zobrist::cellKey(cellIndex(x, y), value);
+        }
+    }
+}
+
+void BoardSnapshot::setLayout(const uint64_t* mineBits) {
+    int cellCount = gridSize * gridSize;
+    layout.assign(cellCount, 0);
+    for (int index = 0; index < cellCount; index++) {
+        if ((mineBits[index / 64] >> (index % 64)) & 1) layout[index] = IBoardSolver::BOMB;
+    }
+
+    int neighbors[8];
+    for (int index = 0; index < cellCount; index++) {
+        if (layout[index] == IBoardSolver::BOMB) continue;
+        int count = getNeighbors(index, neighbors);
+        for (int i = 0; i < count; i++) {
+            if (layout[neighbors[i]] == IBoardSolver::BOMB) layout[index]++;
+        }
+    }
+}
+
+IBoardSolver::GameState BoardSnapshot::getGameState() const {
+    if (minesRevealed > 0) return IBoardSolver::LOST;
+    if (safeRevealed == gridSize * gridSize - totalMines) return IBoardSolver::WON;
+    return IBoardSolver::PLAYING;
+}
+
+void BoardSnapshot::rollback(size_t toMark) {
+    while (journal.size() > toMark) {
+        const UndoEntry& entry = journal.back();
+        adjustCounts(cells[entry.index], -1);
+        hash ^= zobrist::cellKey(entry.index, cells[entry.index]) ^ zobrist::cellKey(entry.index, entry.previous);
+        cells[entry.index] = entry.previous;
+        adjustCounts(entry.previous, 1);
+        journal.pop_back();
+    }
+}
+
+void BoardSnapshot::assumeValue(int index, int value) {
+    if (cells[index] >= 0) return; // Already revealed
+    set(index, static_cast<int8_t>(value));
+}
+
+void BoardSnapshot::toggleFlag(int index) {
+    if (cells[index] >= 0) return; // Can't flag a revealed cell
+    set(index, cells[index] == FLAGGED ? UNKNOWN : FLAGGED);
+}
+
+int BoardSnapshot::reveal(int index) {
+    if (layout.empty() || cells[index] != UNKNOWN || getGameState() != IBoardSolver::PLAYING) return 0;
+
+    // Same rules as Board::revealCell: zeros open their neighbors, flagged ones included
+    int uncovered = 1;
+    set(index, static_cast<int8_t>(layout[index]));
+    if (layout[index] != IBoardSolver::ZERO) return uncovered;
+
+    int neighbors[8];
+    pending.clear();
+    pending.push_back(index);
+    while (!pending.empty()) {
+        int current = pending.back();
+        pending.pop_back();
+        int count = getNeighbors(current, neighbors);
+        for (int i = 0; i < count; i++) {
+            int neighbor = neighbors[i];
+            if (cells[neighbor] >= 0) continue;
+            set(neighbor, static_cast<int8_t>(layout[neighbor]));
+            uncovered++;
+            if (layout[neighbor] == IBoardSolver::ZERO) pending.push_back(neighbor);
+        }
+    }
+    return uncovered;
+}
+
+vector<BoardSnapshot::FrontierComponent> BoardSnapshot::getFrontierComponents() const {
+    vector<FrontierComponent> components;
+    vector<bool> visited(cells.size(), false);
+    vector<int> queue;
+    int neighbors[8];
+
+    for (int start = 0; start < static_cast<int>(cells.size()); start++) {
+        if (visited[start] || cells[start] < 0 || cells[start] == IBoardSolver::BOMB) continue;
+
+        // Grow from a revealed number through its unknown neighbors to the numbers they touch
+        FrontierComponent component;
+        visited[start] = true;
+        queue.assign(1, start);
+        while (!queue.empty()) {
+            int index = queue.back();
+            queue.pop_back();
+            bool isNumber = cells[index] >= 0;
+            int count = getNeighbors(index, neighbors);
+            if (isNumber) {
+                bool touchesUnknown = false;
+                for (int i = 0; i < count; i++) {
+                    if (cells[neighbors[i]] != UNKNOWN) continue;
+                    touchesUnknown = true;
+                    if (!visited[neighbors[i]]) {
+                        visited[neighbors[i]] = true;
+                        queue.push_back(neighbors[i]);
+                    }
+                }
+                if (touchesUnknown) component.numbers.push_back(index);
+            } else {
+                component.unknowns.push_back(index);
+                for (int i = 0; i < count; i++) {
+                    int neighbor = neighbors[i];
+                    if (visited[neighbor] || cells[neighbor] < 0 || cells[neighbor] == IBoardSolver::BOMB) continue;
+                    visited[neighbor] = true;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+        if (component.unknowns.empty()) continue; // Number with nothing left to decide
+
+        sort(component.unknowns.begin(), component.unknowns.end());
+        sort(component.numbers.begin(), component.numbers.end());
+
+        components.push_back(move(component));
+    }
+    return components;
+}
+
+int BoardSnapshot::getNeighbors(int index, int* neighbors) const {
+    int x = index % gridSize;
+    int y = index / gridSize;
+    int count = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (dx == 0 && dy == 0) continue;
+            int nx = x + dx;
+            int ny = y + dy;
+            if (nx < 0 || nx >= gridSize || ny < 0 || ny >= gridSize) continue;
+            neighbors[count++] = ny * gridSize + nx;
+        }
+    }
+    return count;
+}
+
+void BoardSnapshot::set(int index, int8_t value) {
+    journal.push_back({index, cells[index]});
+    adjustCounts(cells[index], -1);
+    hash ^= zobrist::cellKey(index, cells[index]) ^ zobrist::cellKey(index, value);
+    cells[index] = value;
+    adjustCounts(value, 1);
+}
+
+void BoardSnapshot::adjustCounts(int8_t value, int delta) {
+    if (value == UNKNOWN) unknownCount += delta;
+    else if (value == FLAGGED) flagCount += delta;
+    else if (value == IBoardSolver::BOMB) minesRevealed += delta;
+    else safeRevealed += delta;
+}
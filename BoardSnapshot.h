@@ -0,0 +1,93 @@
+#ifndef BOARDSNAPSHOT_H
+#define BOARDSNAPSHOT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "IBoardSolver.h"
+
+/**
+ * Copyable player-view board state for solver lookahead.
+ * Cells live in one flat byte array (index = y * gridSize + x) using the
+ * getPlayerView() encoding, so copying a snapshot is a single memcpy.
+ *
+ * Speculative moves go through an undo journal: take mark(), try moves,
+ * then rollback(mark) to undo exactly the cells they touched.
+ * Without a layout, reveals are hypothetical (assumeValue); with a layout
+ * attached (e.g. a sampled mine arrangement) reveal() floods like Board.
+ * The Zobrist hash is kept in step with Board::getViewHash().
+ */
+class BoardSnapshot {
+public:
+    static constexpr std::int8_t UNKNOWN = -1;
+    static constexpr std::int8_t FLAGGED = -2;
+
+    // Unknown cells tied together by shared revealed numbers
+    struct FrontierComponent {
+        std::vector<int> unknowns;
+        std::vector<int> numbers;
+    };
+
+private:
+    struct UndoEntry {
+        int index;
+        std::int8_t previous;
+    };
+
+    int gridSize = 0;
+    int totalMines = 0;
+    std::vector<std::int8_t> cells;
+    std::vector<std::uint8_t> layout; // True cell values, empty when unknown
+    std::vector<UndoEntry> journal;
+    std::vector<int> pending; // Flood fill scratch
+
+    int unknownCount = 0;
+    int flagCount = 0;
+    int safeRevealed = 0;
+    int minesRevealed = 0;
+    std::uint64_t hash = 0;
+
+public:
+    BoardSnapshot() = default;
+    explicit BoardSnapshot(const IBoardSolver& board) { capture(board); }
+
+    // Copy the player view; clears the layout and the journal
+    void capture(const IBoardSolver& board);
+    // Attach a full mine layout (bit i = cell index i) so reveal() knows outcomes
+    void setLayout(const std::uint64_t* mineBits);
+    bool hasLayout() const { return !layout.empty(); }
+
+    int getGridSize() const { return gridSize; }
+    int getTotalMines() const { return totalMines; }
+    int cellIndex(int x, int y) const { return y * gridSize + x; }
+    int get(int index) const { return cells[index]; }
+    int get(int x, int y) const { return cells[cellIndex(x, y)]; }
+    bool isUnknown(int index) const { return cells[index] == UNKNOWN; }
+
+    int getUnknownCount() const { return unknownCount; }
+    int getFlagCount() const { return flagCount; }
+    IBoardSolver::GameState getGameState() const;
+    std::uint64_t getHash() const { return hash; }
+
+    std::vector<FrontierComponent> getFrontierComponents() const;
+
+    // Speculation
+    std::size_t mark() const { return journal.size(); }
+    void rollback(std::size_t toMark);
+    void commit() { journal.clear(); } // Keep the current state as the new baseline
+
+    // Hypothetical outcome for a cell (0-8 or BOMB); no flood fill
+    void assumeValue(int index, int value);
+    void toggleFlag(int index);
+    // Reveal using the attached layout; returns the number of cells uncovered
+    int reveal(int index);
+
+    // Neighbor indices of a cell, returns how many were written (at most 8)
+    int getNeighbors(int index, int* neighbors) const;
+
+private:
+    void set(int index, std::int8_t value);
+    void adjustCounts(std::int8_t value, int delta);
+};
+
+#endif
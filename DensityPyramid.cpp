@@ -0,0 +1,108 @@
+#include "DensityPyramid.h"
+
+using namespace std;
+
+bool DensityPyramid::sync(const Board& board) {
+    const vector<int>& changeLog = board.getChangeLog();
+    rebuilt = false;
+
+    // New game or resized board: start over
+    if (!built || board.getChangeEpoch() != syncedEpoch || board.getGridSize() != gridSize
+        || changeLog.size() < syncedLogSize) {
+        rebuild(board);
+        rebuilt = true;
+        return true;
+    }
+
+    if (changeLog.size() == syncedLogSize) return false;
+
+    for (size_t i = syncedLogSize; i < changeLog.size(); i++) {
+        applyCell(board, changeLog[i]);
+    }
+    syncedLogSize = changeLog.size();
+    return true;
+}
+
+void DensityPyramid::clearDirty() {
+    for (size_t level = 0; level < dirtyTiles.size(); level++) {
+        for (int tileIndex : dirtyTiles[level]) {
+            dirtyMarks[level][tileIndex] = false;
+        }
+        dirtyTiles[level].clear();
+    }
+}
+
+void DensityPyramid::rebuild(const Board& board) {
+    gridSize = board.getGridSize();
+    cellStates.assign(gridSize * gridSize, UNKNOWN);
+    levels.clear();
+    levelWidths.clear();
+
+    // Level widths halve (rounding up) until a single tile covers the board
+    int width = gridSize;
+    while (true) {
+        levelWidths.push_back(width);
+        levels.emplace_back(width * width);
+        if (width == 1) break;
+        width = (width + 1) / 2;
+    }
+
+    for (int y = 0; y < gridSize; y++) {
+        for (int x = 0; x < gridSize; x++) {
+            uint8_t state = readState(board, x, y);
+            cellStates[y * gridSize + x] = state;
+            for (int level = 0; level < getLevelCount(); level++) {
+                Tile& tile = levels[level][(y >> level) * levelWidths[level] + (x >> level)];
+                tile.cells++;
+                if (state == REVEALED) tile.revealed++;
+                if (state == FLAGGED) tile.flagged++;
+            }
+        }
+    }
+
+    // A rebuild invalidates every tile
+    dirtyTiles.assign(levels.size(), {});
+    dirtyMarks.assign(levels.size(), {});
+    for (int level = 0; level < getLevelCount(); level++) {
+        dirtyMarks[level].assign(levels[level].size(), false);
+        for (int i = 0; i < static_cast<int>(levels[level].size()); i++) {
+            markDirty(level, i);
+        }
+    }
+
+    syncedEpoch = board.getChangeEpoch();
+    syncedLogSize = board.getChangeLog().size();
+    built = true;
+}
+
+void DensityPyramid::applyCell(const Board& board, int index) {
+    int x = index % gridSize;
+    int y = index / gridSize;
+    uint8_t oldState = cellStates[index];
+    uint8_t newState = readState(board, x, y);
+    if (oldState == newState) return;
+    cellStates[index] = newState;
+
+    // Walk up the pyramid adjusting the counts of every tile that covers this cell
+    for (int level = 0; level < getLevelCount(); level++) {
+        int tileIndex = (y >> level) * levelWidths[level] + (x >> level);
+        Tile& tile = levels[level][tileIndex];
+        if (oldState == REVEALED) tile.revealed--;
+        if (oldState == FLAGGED) tile.flagged--;
+        if (newState == REVEALED) tile.revealed++;
+        if (newState == FLAGGED) tile.flagged++;
+        markDirty(level, tileIndex);
+    }
+}
+
+uint8_t DensityPyramid::readState(const Board& board, int x, int y) const {
+    if (board.isRevealed(x, y)) return REVEALED;
+    if (board.isFlagged(x, y)) return FLAGGED;
+    return UNKNOWN;
+}
+
+void DensityPyramid::markDirty(int level, int tileIndex) {
+    if (dirtyMarks[level][tileIndex]) return;
+    dirtyMarks[level][tileIndex] = true;
+    dirtyTiles[level].push_back(tileIndex);
+}
@@ -0,0 +1,62 @@
+#ifndef DENSITYPYRAMID_H
+#define DENSITYPYRAMID_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Board.h"
+
+/**
+ * Mip-pyramid of revealed / flagged / unknown cell counts used for
+ * level-of-detail rendering of large boards.
+ * Level 0 holds one tile per cell, level k holds one tile per 2^k x 2^k block.
+ * Kept in sync incrementally from the board's change journal.
+ */
+class DensityPyramid {
+public:
+    struct Tile {
+        std::uint32_t revealed = 0;
+        std::uint32_t flagged = 0;
+        std::uint32_t cells = 0; // Edge tiles cover fewer cells than 4^level
+    };
+
+private:
+    enum CellState : std::uint8_t { UNKNOWN = 0, REVEALED = 1, FLAGGED = 2 };
+
+    int gridSize = 0;
+    std::vector<std::uint8_t> cellStates;
+    std::vector<std::vector<Tile>> levels;
+    std::vector<int> levelWidths;
+
+    // Tiles touched since the last clearDirty(), per level
+    std::vector<std::vector<int>> dirtyTiles;
+    std::vector<std::vector<bool>> dirtyMarks;
+
+    // Position in the board's change journal
+    unsigned int syncedEpoch = 0;
+    std::size_t syncedLogSize = 0;
+    bool built = false;
+    bool rebuilt = false; // The last sync() started over
+
+public:
+    // Bring the pyramid up to date with the board; returns true if anything changed
+    bool sync(const Board& board);
+    // True if the last sync() rebuilt every level (new game or resized board)
+    bool wasRebuilt() const { return rebuilt; }
+
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    int getLevelWidth(int level) const { return levelWidths[level]; }
+    const Tile& getTile(int level, int tx, int ty) const { return levels[level][ty * levelWidths[level] + tx]; }
+
+    // Dirty tile indices (ty * width + tx) for a level since the last clearDirty()
+    const std::vector<int>& getDirtyTiles(int level) const { return dirtyTiles[level]; }
+    void clearDirty();
+
+private:
+    void rebuild(const Board& board);
+    void applyCell(const Board& board, int index);
+    std::uint8_t readState(const Board& board, int x, int y) const;
+    void markDirty(int level, int tileIndex);
+};
+
+#endif
@@ -0,0 +1,42 @@
+#include "FramePacer.h"
+
+FramePacer::FramePacer(sf::RenderWindow& w) : window(&w) {
+    applyLimits();
+}
+
+void FramePacer::setFpsCap(unsigned int fps) {
+    fpsCap = fps;
+    applyLimits();
+}
+
+void FramePacer::setVsync(bool enabled) {
+    vsyncEnabled = enabled;
+    applyLimits();
+}
+
+std::optional<sf::Event> FramePacer::waitForEvent(bool animating, const std::optional<TimePoint>& wakeAt) {
+    // Animations need every frame; the frame limit paces them inside display()
+    if (animating) return window->pollEvent();
+
+    if (wakeAt) {
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(*wakeAt - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) return window->pollEvent();
+
+        // Sleep until either input arrives or the solver's next move is due
+        return window->waitEvent(sf::microseconds(remaining.count()));
+    }
+
+    // Nothing to do until the user does something
+    return window->waitEvent();
+}
+
+void FramePacer::applyLimits() {
+    // SFML recommends never combining vsync with a frame rate limit
+    if (vsyncEnabled) {
+        window->setFramerateLimit(0);
+        window->setVerticalSyncEnabled(true);
+    } else {
+        window->setVerticalSyncEnabled(false);
+        window->setFramerateLimit(fpsCap);
+    }
+}
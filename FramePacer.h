@@ -0,0 +1,42 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <optional>
+
+/**
+ * Controls how often the main loop renders.
+ * Caps the frame rate (or defers to vsync) while something is moving, and
+ * blocks on the event queue when nothing is animating, waking up early only
+ * when a solver has a move scheduled.
+ */
+class FramePacer {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    static constexpr unsigned int DEFAULT_FPS_CAP = 60;
+
+private:
+    sf::RenderWindow* window;
+    unsigned int fpsCap = DEFAULT_FPS_CAP; // 0 = uncapped
+    bool vsyncEnabled = false;
+
+public:
+    FramePacer(sf::RenderWindow& window);
+
+    // Frame rate limiting (vsync and the FPS cap are mutually exclusive)
+    void setFpsCap(unsigned int fps);
+    unsigned int getFpsCap() const { return fpsCap; }
+    void setVsync(bool enabled);
+    bool isVsyncEnabled() const { return vsyncEnabled; }
+
+    // Returns the first event of the next frame, blocking while idle.
+    // animating: something on screen changes every frame, so never block.
+    // wakeAt: earliest time a solver needs the loop to run again (if any).
+    std::optional<sf::Event> waitForEvent(bool animating, const std::optional<TimePoint>& wakeAt);
+
+private:
+    void applyLimits();
+};
+
+#endif
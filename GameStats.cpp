@@ -0,0 +1,251 @@
+#include "GameStats.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const char* GameMetrics::ruleName(int rule) {
+    static const char* const NAMES[RULE_COUNT] = {
+        "satisfied_number", "filled_number", "subtraction", "pattern_table",
+        "constraint_proof", "zero_probability", "belief", "guess_search"};
+    return rule >= 0 && rule < RULE_COUNT ? NAMES[rule] : "unknown";
+}
+
+GameStats::Histogram::Histogram(int width, int binCount) : width(max(1, width)), bins(max(1, binCount)) {}
+
+void GameStats::Histogram::add(int value) {
+    int bin = min(max(0, value) / width, getBinCount() - 1);
+    bump(bins[bin], 1);
+}
+
+// Bins are moved by their lower edge, so differently shaped histograms still combine
+void GameStats::Histogram::merge(const Histogram& other) {
+    for (int bin = 0; bin < other.getBinCount(); bin++) {
+        uint64_t count = other.getCount(bin);
+        if (count > 0) bump(bins[min(bin * other.width / width, getBinCount() - 1)], count);
+    }
+}
+
+void GameStats::Histogram::clear() {
+    for (Counter& bin : bins) bin.store(0, memory_order_relaxed);
+}
+
+void GameStats::Histogram::writeState(ostream& out) const {
+    out << width << " " << getBinCount();
+    for (int bin = 0; bin < getBinCount(); bin++) out << " " << getCount(bin);
+    out << "\n";
+}
+
+bool GameStats::Histogram::readState(istream& in) {
+    int savedWidth = 0, savedBins = 0;
+    if (!(in >> savedWidth >> savedBins) || savedWidth != width || savedBins != getBinCount()) return false;
+    for (Counter& bin : bins) {
+        uint64_t count = 0;
+        if (!(in >> count)) return false;
+        bump(bin, count);
+    }
+    return true;
+}
+
+// Bucket i holds values in (MIN_VALUE * gamma^(i-1), MIN_VALUE * gamma^i]
+static const double GAMMA = (1.0 + GameStats::QuantileSketch::RELATIVE_ERROR) / (1.0 - GameStats::QuantileSketch::RELATIVE_ERROR);
+static const double LOG_GAMMA = log(GAMMA);
+
+GameStats::QuantileSketch::QuantileSketch() : buckets(BUCKETS) {}
+
+void GameStats::QuantileSketch::add(double value) {
+    int bucket = value <= MIN_VALUE ? 0 : static_cast<int>(ceil(log(value / MIN_VALUE) / LOG_GAMMA));
+    bump(buckets[min(bucket, BUCKETS - 1)], 1);
+    bump(total, 1);
+}
+
+void GameStats::QuantileSketch::merge(const QuantileSketch& other) {
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        uint64_t count = other.buckets[bucket].load(memory_order_relaxed);
+        if (count > 0) bump(buckets[bucket], count);
+    }
+    bump(total, other.getCount());
+}
+
+void GameStats::QuantileSketch::clear() {
+    for (Counter& bucket : buckets) bucket.store(0, memory_order_relaxed);
+    total.store(0, memory_order_relaxed);
+}
+
+void GameStats::QuantileSketch::writeState(ostream& out) const {
+    int used = 0;
+    for (const Counter& bucket : buckets) used += bucket.load(memory_order_relaxed) > 0;
+    out << used;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        uint64_t count = buckets[bucket].load(memory_order_relaxed);
+        if (count > 0) out << " " << bucket << " " << count;
+    }
+    out << "\n";
+}
+
+bool GameStats::QuantileSketch::readState(istream& in) {
+    int used = 0;
+    if (!(in >> used)) return false;
+    for (int i = 0; i < used; i++) {
+        int bucket = 0;
+        uint64_t count = 0;
+        if (!(in >> bucket >> count) || bucket < 0 || bucket >= BUCKETS) return false;
+        bump(buckets[bucket], count);
+        bump(total, count);
+    }
+    return true;
+}
+
+double GameStats::QuantileSketch::quantile(double q) const {
+    uint64_t count = getCount();
+    if (count == 0) return 0.0;
+    uint64_t rank = static_cast<uint64_t>(min(max(q, 0.0), 1.0) * (count - 1));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += buckets[bucket].load(memory_order_relaxed);
+        if (seen > rank) {
+            // The point within 2% of both bucket edges
+            return bucket == 0 ? MIN_VALUE : MIN_VALUE * 2.0 * pow(GAMMA, bucket) / (GAMMA + 1.0);
+        }
+    }
+    return MIN_VALUE * pow(GAMMA, BUCKETS - 1); // Counts still arriving from the writer
+}
+
+GameStats::GameStats(int gridSize)
+    : moveHistogram((gridSize * gridSize + HISTOGRAM_BINS - 1) / HISTOGRAM_BINS, HISTOGRAM_BINS),
+      guessHistogram(1, HISTOGRAM_BINS),
+      threeBVHistogram((gridSize * gridSize + 2 * HISTOGRAM_BINS - 1) / (2 * HISTOGRAM_BINS), HISTOGRAM_BINS) {}
+
+void GameStats::record(const GameMetrics& game) {
+    bump(games, 1);
+    bump(wins, game.won ? 1 : 0);
+    bump(moves, static_cast<uint64_t>(game.moves));
+    bump(guesses, static_cast<uint64_t>(game.guesses));
+    bump(micros, static_cast<uint64_t>(llround(max(0.0, game.seconds) * 1e6)));
+    bump(missedSafeMoves, static_cast<uint64_t>(game.missedSafeMoves));
+    bump(lostAfterMiss, !game.won && game.missedSafeMoves > 0 ? 1 : 0);
+    bump(uncheckedGuesses, static_cast<uint64_t>(game.uncheckedGuesses));
+    for (int rule = 0; rule < GameMetrics::RULE_COUNT; rule++) bump(deductions[rule], static_cast<uint64_t>(game.deductions[rule]));
+    time.add(game.seconds);
+    moveHistogram.add(game.moves);
+    guessHistogram.add(game.guesses);
+    threeBVHistogram.add(game.threeBV);
+}
+
+void GameStats::merge(const GameStats& other) {
+    bump(games, other.getGames());
+    bump(wins, other.getWins());
+    bump(moves, other.getMoves());
+    bump(guesses, other.getGuesses());
+    bump(micros, read(other.micros));
+    bump(missedSafeMoves, other.getMissedSafeMoves());
+    bump(lostAfterMiss, other.getLostAfterMiss());
+    bump(uncheckedGuesses, other.getUncheckedGuesses());
+    for (int rule = 0; rule < GameMetrics::RULE_COUNT; rule++) bump(deductions[rule], other.getDeductions(rule));
+    time.merge(other.time);
+    moveHistogram.merge(other.moveHistogram);
+    guessHistogram.merge(other.guessHistogram);
+    threeBVHistogram.merge(other.threeBVHistogram);
+}
+
+void GameStats::clear() {
+    for (Counter* counter : {&games, &wins, &moves, &guesses, &micros, &missedSafeMoves, &lostAfterMiss, &uncheckedGuesses}) {
+        counter->store(0, memory_order_relaxed);
+    }
+    for (Counter& counter : deductions) counter.store(0, memory_order_relaxed);
+    time.clear();
+    moveHistogram.clear();
+    guessHistogram.clear();
+    threeBVHistogram.clear();
+}
+
+static double perGame(uint64_t total, uint64_t games) {
+    return games > 0 ? static_cast<double>(total) / games : 0.0;
+}
+
+static string binLabel(const GameStats::Histogram& histogram, int bin) {
+    int from = bin * histogram.getWidth();
+    if (bin == histogram.getBinCount() - 1) return to_string(from) + "+";
+    return histogram.getWidth() == 1 ? to_string(from) : to_string(from) + "-" + to_string(from + histogram.getWidth() - 1);
+}
+
+void GameStats::writeCsv(ostream& out) const {
+    uint64_t played = getGames();
+    out << "metric,key,value\n";
+    out << "games,," << played << "\n";
+    out << "wins,," << getWins() << "\n";
+    out << "win_rate,," << perGame(getWins(), played) << "\n";
+    out << "moves_per_game,," << perGame(getMoves(), played) << "\n";
+    out << "guesses_per_game,," << perGame(getGuesses(), played) << "\n";
+    out << "seconds_per_game,," << (played > 0 ? getSeconds() / played : 0.0) << "\n";
+    out << "seconds_p50,," << timeQuantile(0.5) << "\n";
+    out << "seconds_p99,," << timeQuantile(0.99) << "\n";
+    out << "missed_safe_moves,," << getMissedSafeMoves() << "\n";
+    out << "lost_after_miss,," << getLostAfterMiss() << "\n";
+    out << "unchecked_guesses,," << getUncheckedGuesses() << "\n";
+    for (int rule = 0; rule < GameMetrics::RULE_COUNT; rule++) {
+        out << "deductions," << GameMetrics::ruleName(rule) << "," << getDeductions(rule) << "\n";
+    }
+    const pair<const char*, const Histogram*> histograms[] = {
+        {"moves_histogram", &moveHistogram}, {"guesses_histogram", &guessHistogram}, {"three_bv_histogram", &threeBVHistogram}};
+    for (const auto& [name, histogram] : histograms) {
+        for (int bin = 0; bin < histogram->getBinCount(); bin++) {
+            out << name << "," << binLabel(*histogram, bin) << "," << histogram->getCount(bin) << "\n";
+        }
+    }
+}
+
+void GameStats::writeJson(ostream& out) const {
+    uint64_t played = getGames();
+    out << "{\n";
+    out << "  \"games\": " << played << ",\n";
+    out << "  \"wins\": " << getWins() << ",\n";
+    out << "  \"win_rate\": " << perGame(getWins(), played) << ",\n";
+    out << "  \"moves_per_game\": " << perGame(getMoves(), played) << ",\n";
+    out << "  \"guesses_per_game\": " << perGame(getGuesses(), played) << ",\n";
+    out << "  \"seconds_per_game\": " << (played > 0 ? getSeconds() / played : 0.0) << ",\n";
+    out << "  \"seconds_p50\": " << timeQuantile(0.5) << ",\n";
+    out << "  \"seconds_p99\": " << timeQuantile(0.99) << ",\n";
+    out << "  \"missed_safe_moves\": " << getMissedSafeMoves() << ",\n";
+    out << "  \"lost_after_miss\": " << getLostAfterMiss() << ",\n";
+    out << "  \"unchecked_guesses\": " << getUncheckedGuesses() << ",\n";
+    out << "  \"deductions\": {";
+    for (int rule = 0; rule < GameMetrics::RULE_COUNT; rule++) {
+        out << (rule ? ", " : "") << "\"" << GameMetrics::ruleName(rule) << "\": " << getDeductions(rule);
+    }
+    out << "},\n";
+    const pair<const char*, const Histogram*> histograms[] = {
+        {"moves_histogram", &moveHistogram}, {"guesses_histogram", &guessHistogram}, {"three_bv_histogram", &threeBVHistogram}};
+    for (size_t h = 0; h < 3; h++) {
+        const Histogram& histogram = *histograms[h].second;
+        out << "  \"" << histograms[h].first << "\": {\"width\": " << histogram.getWidth() << ", \"counts\": [";
+        for (int bin = 0; bin < histogram.getBinCount(); bin++) out << (bin ? ", " : "") << histogram.getCount(bin);
+        out << "]}" << (h + 1 < 3 ? "," : "") << "\n";
+    }
+    out << "}\n";
+}
+
+void GameStats::writeState(ostream& out) const {
+    out << getGames() << " " << getWins() << " " << getMoves() << " " << getGuesses() << " " << read(micros) << " "
+        << getMissedSafeMoves() << " " << getLostAfterMiss() << " " << getUncheckedGuesses() << "\n";
+    for (int rule = 0; rule < GameMetrics::RULE_COUNT; rule++) out << (rule ? " " : "") << getDeductions(rule);
+    out << "\n";
+    time.writeState(out);
+    moveHistogram.writeState(out);
+    guessHistogram.writeState(out);
+    threeBVHistogram.writeState(out);
+}
+
+bool GameStats::readState(istream& in) {
+    for (Counter* counter : {&games, &wins, &moves, &guesses, &micros, &missedSafeMoves, &lostAfterMiss, &uncheckedGuesses}) {
+        uint64_t value = 0;
+        if (!(in >> value)) return false;
+        bump(*counter, value);
+    }
+    for (Counter& counter : deductions) {
+        uint64_t value = 0;
+        if (!(in >> value)) return false;
+        bump(counter, value);
+    }
+    return time.readState(in) && moveHistogram.readState(in) && guessHistogram.readState(in) && threeBVHistogram.readState(in);
+}
@@ -0,0 +1,146 @@
+#ifndef GAMESTATS_H
+#define GAMESTATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// What one solver game cost, filled in as it is played
+struct GameMetrics {
+    // Where certain moves came from
+    enum Rule {
+        SATISFIED_NUMBER, // Number with all its mines flagged opens the rest
+        FILLED_NUMBER,    // Number needing every unknown neighbor flags them
+        SUBTRACTION,
+        PATTERN_TABLE,
+        CONSTRAINT_PROOF,
+        ZERO_PROBABILITY,
+        BELIEF,
+        GUESS_SEARCH,     // Searched "guess" that was certain after all
+        RULE_COUNT
+    };
+    static const char* ruleName(int rule);
+
+    bool won = false;
+    int moves = 0;   // Reveals and flags the solver clicked
+    int guesses = 0; // Reveals without a certain deduction behind them
+    std::array<int, RULE_COUNT> deductions{};
+    double seconds = 0.0; // Wall time from the new board to the last move
+    int threeBV = 0;
+    int missedSafeMoves = 0;  // Guesses that risked a mine while another cell was provably safe
+    int uncheckedGuesses = 0; // Guesses the oracle could only judge with local constraints
+};
+
+/**
+ * Streaming per-game statistics for one solver, merged on demand across solvers.
+ *
+ * Only the owning thread records; every counter is an atomic written with a plain
+ * relaxed load and store (no locks, no read-modify-write), so the GUI or a
+ * reporter can read it while games are running. Fixed sizes throughout, so
+ * recording never allocates.
+ *
+ * Time per game goes into a log-bucketed quantile sketch: each bucket is 2% wide,
+ * so any quantile is within 2% of the true value whatever the distribution, and
+ * sketches merge by adding counts. Moves, guesses and 3BV go into linear histograms
+ * sized for the board (the last bin takes everything above).
+ */
+class GameStats {
+public:
+    using Counter = std::atomic<std::uint64_t>;
+
+    class Histogram {
+    private:
+        int width;
+        std::vector<Counter> bins;
+
+    public:
+        Histogram(int width, int binCount);
+        void add(int value);
+        void merge(const Histogram& other);
+        void clear();
+        void writeState(std::ostream& out) const;
+        bool readState(std::istream& in);
+        int getWidth() const { return width; }
+        int getBinCount() const { return static_cast<int>(bins.size()); }
+        std::uint64_t getCount(int bin) const { return bins[bin].load(std::memory_order_relaxed); }
+    };
+
+    class QuantileSketch {
+    public:
+        static constexpr double RELATIVE_ERROR = 0.02;
+        static constexpr double MIN_VALUE = 1e-6; // Smaller values share the first bucket
+        static const int BUCKETS = 640;           // Reaches past a day
+
+    private:
+        std::vector<Counter> buckets;
+        Counter total{0};
+
+    public:
+        QuantileSketch();
+        void add(double value);
+        void merge(const QuantileSketch& other);
+        void clear();
+        void writeState(std::ostream& out) const; // Only the non-empty buckets
+        bool readState(std::istream& in);
+        double quantile(double q) const; // 0 when empty
+        std::uint64_t getCount() const { return total.load(std::memory_order_relaxed); }
+    };
+
+    static const int HISTOGRAM_BINS = 20;
+
+private:
+    Counter games{0};
+    Counter wins{0};
+    Counter moves{0};
+    Counter guesses{0};
+    Counter micros{0};
+    Counter missedSafeMoves{0};
+    Counter lostAfterMiss{0}; // Lost games with at least one missed safe move
+    Counter uncheckedGuesses{0};
+    std::array<Counter, GameMetrics::RULE_COUNT> deductions{};
+    QuantileSketch time;
+    Histogram moveHistogram;
+    Histogram guessHistogram;
+    Histogram threeBVHistogram;
+
+    static void bump(Counter& counter, std::uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    static std::uint64_t read(const Counter& counter) { return counter.load(std::memory_order_relaxed); }
+
+public:
+    explicit GameStats(int gridSize);
+
+    void record(const GameMetrics& game); // Owning thread only
+    void merge(const GameStats& other);   // Into this one; histograms must have the same shape
+    void clear();
+
+    std::uint64_t getGames() const { return read(games); }
+    std::uint64_t getWins() const { return read(wins); }
+    std::uint64_t getMoves() const { return read(moves); }
+    std::uint64_t getGuesses() const { return read(guesses); }
+    std::uint64_t getDeductions(int rule) const { return read(deductions[rule]); }
+    std::uint64_t getMissedSafeMoves() const { return read(missedSafeMoves); }
+    std::uint64_t getLostAfterMiss() const { return read(lostAfterMiss); }
+    std::uint64_t getUncheckedGuesses() const { return read(uncheckedGuesses); }
+    double getSeconds() const { return read(micros) / 1e6; }
+    double timeQuantile(double q) const { return time.quantile(q); }
+    const Histogram& getMoveHistogram() const { return moveHistogram; }
+    const Histogram& getGuessHistogram() const { return guessHistogram; }
+    const Histogram& getThreeBVHistogram() const { return threeBVHistogram; }
+
+    // Long format (metric,key,value), one row per number, easy to pivot
+    void writeCsv(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+
+    // Every count as whitespace-separated numbers, for checkpoints. Reading adds to this one
+    // like merge(); false if the text is malformed or the histograms are shaped differently
+    void writeState(std::ostream& out) const;
+    bool readState(std::istream& in);
+};
+
+#endif
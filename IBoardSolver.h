@@ -2,6 +2,7 @@
 #define IBOARDSOLVER_H
 
 #include <vector>
+#include <cstdint>
 
 /**
  * Interface for algo solvers to interact with the game board.
@@ -16,6 +17,8 @@ enum CellVal { ZERO = 0, ONE = 1, TWO = 2, THREE = 3, FOUR = 4, FIVE = 5, SIX =
     
     // Grid information
     virtual int getGridSize() const = 0;
+    virtual int getTotalMines() const = 0;
+    virtual int getThreeBV() const = 0; // Clicks needed to clear the board without flags
     
     // Cell selection
     virtual int getSelectedX() const = 0;
@@ -26,6 +29,12 @@ enum CellVal { ZERO = 0, ONE = 1, TWO = 2, THREE = 3, FOUR = 4, FIVE = 5, SIX =
     // -1 = unrevealed, -2 = flagged, 0-8 = number, 9 = bomb (only visible when revealed)
     virtual std::vector<std::vector<int>> getPlayerView() const = 0;
     virtual int getCellVal(int x, int y) const = 0;
+    virtual int getViewState(int x, int y) const = 0; // One cell of getPlayerView()
+    virtual std::uint64_t getViewHash() const = 0; // Changes whenever the player view does
+
+    // Change journal: cells whose view changed this game; the epoch moves on every new game
+    virtual unsigned int getChangeEpoch() const = 0;
+    virtual const std::vector<int>& getChangeLog() const = 0;
     
     // Actions
     virtual bool algoClick() = 0;
@@ -0,0 +1,251 @@
+#include "ReplayLog.h"
+#include "Board.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+
+using namespace std;
+
+void replayLog::appendVarint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// ---- ReplayWriter ----
+
+ReplayWriter::~ReplayWriter() {
+    close();
+}
+
+bool ReplayWriter::open(const string& path) {
+    close();
+    
+    // A run killed mid-game leaves a partial record at the end of the file; cut it back to
+    // the last complete move and close it as abandoned so new games start on a clean boundary
+    error_code ec;
+    uintmax_t existingSize = filesystem::exists(path, ec) ? filesystem::file_size(path, ec) : 0;
+    bool closeCrashedGame = false;
+    if (existingSize >= 5) {
+        ReplayReader existing;
+        if (!existing.open(path)) return false; // Not a replay log, don't append to it
+        if (existing.getVersion() != replayLog::VERSION) return false; // Older format, start a new file
+        replayLog::GameRecord record;
+        while (existing.nextGame(record)) {}
+        if (existing.getCleanSize() < existingSize) {
+            filesystem::resize_file(path, existing.getCleanSize(), ec);
+            if (ec) return false;
+        }
+        closeCrashedGame = existing.endsMidGame();
+    } else if (existingSize > 0) {
+        filesystem::resize_file(path, 0, ec); // Header never finished writing
+    }
+    
+    file = fopen(path.c_str(), "ab");
+    if (!file) return false;
+
+    // Append mode starts at the end, so an empty file still needs its header
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        buffer.insert(buffer.end(), replayLog::MAGIC, replayLog::MAGIC + 4);
+        buffer.push_back(replayLog::VERSION);
+    }
+    if (closeCrashedGame) {
+        replayLog::appendVarint(buffer, 0);
+        replayLog::appendVarint(buffer, static_cast<uint64_t>(IBoardSolver::PLAYING));
+    }
+    return true;
+}
+
+void ReplayWriter::close() {
+    if (!file) return;
+    if (gameOpen) endGame(IBoardSolver::PLAYING);
+    flush();
+    fclose(file);
+    file = nullptr;
+}
+
+void ReplayWriter::flush() {
+    if (!file || buffer.empty()) return;
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    fflush(file);
+    buffer.clear();
+}
+
+void ReplayWriter::beginGame(uint64_t seed, int gridSize, int mines, bool firstClickSafe) {
+    if (!file) return;
+    if (gameOpen) endGame(IBoardSolver::PLAYING);
+    pendingSeed = seed;
+    pendingGridSize = gridSize;
+    pendingMines = mines;
+    pendingFirstClickSafe = firstClickSafe;
+    headerWritten = false;
+    gameOpen = true;
+}
+
+void ReplayWriter::recordMove(int cellIndex, IBoardSolver::ClickMode action) {
+    if (!file || !gameOpen) return;
+    if (!headerWritten) {
+        replayLog::appendVarint(buffer, pendingSeed);
+        replayLog::appendVarint(buffer, static_cast<uint64_t>(pendingGridSize));
+        replayLog::appendVarint(buffer, static_cast<uint64_t>(pendingMines));
+        replayLog::appendVarint(buffer, pendingFirstClickSafe ? replayLog::FIRST_CLICK_SAFE : 0);
+        headerWritten = true;
+    }
+    uint64_t encoded = static_cast<uint64_t>(cellIndex) * 2 + (action == IBoardSolver::FLAG ? 1 : 0);
+    replayLog::appendVarint(buffer, encoded + 1); // 0 is reserved for end-of-moves
+    flushIfFull();
+}
+
+void ReplayWriter::endGame(IBoardSolver::GameState result) {
+    if (!file || !gameOpen) return;
+    gameOpen = false;
+    if (!headerWritten) return; // No moves were made, nothing to record
+    replayLog::appendVarint(buffer, 0);
+    replayLog::appendVarint(buffer, static_cast<uint64_t>(result));
+    flushIfFull();
+}
+
+void ReplayWriter::flushIfFull() {
+    if (buffer.size() >= FLUSH_THRESHOLD) flush();
+}
+
+// ---- ReplayReader ----
+
+bool ReplayReader::open(const string& path) {
+    ifstream in(path, ios::binary);
+    if (!in) return false;
+    data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    if (data.size() < 5 || memcmp(data.data(), replayLog::MAGIC, 4) != 0 || data[4] < replayLog::OLDEST_VERSION || data[4] > replayLog::VERSION) {
+        data.clear();
+        return false;
+    }
+    version = data[4];
+    rewind();
+    return true;
+}
+
+void ReplayReader::rewind() {
+    position = 5; // Past the header
+    cleanSize = position;
+    truncatedGame = false;
+}
+
+bool ReplayReader::readVarint(uint64_t& value) {
+    value = 0;
+    int shift = 0;
+    while (position < data.size() && shift < 64) {
+        uint8_t byte = data[position++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+        shift += 7;
+    }
+    return false;
+}
+
+bool ReplayReader::nextGame(replayLog::GameRecord& record) {
+    record = replayLog::GameRecord();
+    uint64_t seed, gridSize, mines;
+    if (!readVarint(seed) || !readVarint(gridSize) || !readVarint(mines)) return false;
+    uint64_t flags = 0;
+    if (version >= 2 && !readVarint(flags)) return false;
+    record.seed = seed;
+    record.gridSize = static_cast<int>(gridSize);
+    record.mines = static_cast<int>(mines);
+    record.firstClickSafe = (flags & replayLog::FIRST_CLICK_SAFE) != 0;
+    cleanSize = position;
+    truncatedGame = true;
+
+    uint64_t encoded;
+    while (readVarint(encoded)) {
+        if (encoded == 0) {
+            uint64_t result;
+            if (readVarint(result)) {
+                record.result = static_cast<IBoardSolver::GameState>(result);
+                record.complete = true;
+                cleanSize = position;
+                truncatedGame = false;
+            }
+            return true;
+        }
+        encoded--;
+        record.moves.push_back({static_cast<int>(encoded / 2), (encoded & 1) ? IBoardSolver::FLAG : IBoardSolver::REVEAL});
+        cleanSize = position;
+    }
+    return true; // Truncated game: still worth replaying up to the crash
+}
+
+// ---- ReplayPlayer ----
+
+ReplayPlayer::ReplayPlayer(Board& b) : board(b) {}
+
+bool ReplayPlayer::open(const string& path) {
+    hasGame = false;
+    gamesLoaded = 0;
+    return reader.open(path);
+}
+
+bool ReplayPlayer::loadNextGame() {
+    hasGame = reader.nextGame(current);
+    nextMove = 0;
+    if (!hasGame) return false;
+    gamesLoaded++;
+    board.setFirstClickSafe(current.firstClickSafe);
+    board.newGame(current.gridSize, current.mines, current.seed);
+    nextMoveTime = chrono::steady_clock::now();
+    return true;
+}
+
+bool ReplayPlayer::skipToGame(int index) {
+    while (gamesLoaded < index + 1) {
+        if (!reader.nextGame(current)) return false;
+        gamesLoaded++;
+    }
+    hasGame = true;
+    nextMove = 0;
+    board.setFirstClickSafe(current.firstClickSafe);
+    board.newGame(current.gridSize, current.mines, current.seed);
+    nextMoveTime = chrono::steady_clock::now();
+    return true;
+}
+
+int ReplayPlayer::step(int maxMoves) {
+    int applied = 0;
+    while (applied < maxMoves && !isGameFinished()) {
+        const replayLog::Move& move = current.moves[nextMove++];
+        int gridSize = board.getGridSize();
+        board.setClickMode(move.action);
+        board.handleClick(move.cellIndex % gridSize, move.cellIndex / gridSize);
+        applied++;
+    }
+    return applied;
+}
+
+int ReplayPlayer::advance() {
+    if (isGameFinished()) return 0;
+    auto now = chrono::steady_clock::now();
+    if (now < nextMoveTime) return 0;
+
+    // Catch up on every move that fell due since the last frame
+    auto interval = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1.0 / movesPerSecond));
+    int due = 1 + static_cast<int>((now - nextMoveTime) / interval);
+    nextMoveTime += interval * due;
+    return step(due);
+}
+
+optional<ReplayPlayer::TimePoint> ReplayPlayer::getNextMoveTime() const {
+    if (isGameFinished()) return nullopt;
+    return nextMoveTime;
+}
+
+bool ReplayPlayer::resultMatches() const {
+    if (!current.complete) return true; // Nothing recorded to compare against
+    return board.getGameState() == current.result;
+}
+
+void ReplayPlayer::setMovesPerSecond(double rate) {
+    movesPerSecond = max(0.25, min(100000.0, rate));
+}
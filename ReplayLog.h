@@ -0,0 +1,146 @@
+#ifndef REPLAYLOG_H
+#define REPLAYLOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+#include "IBoardSolver.h"
+
+class Board;
+
+/**
+ * Compact binary record of played games.
+ *
+ * File layout: "MSRP" magic + version byte, then one record per game:
+ *   varint seed, varint gridSize, varint mines, varint flags (version 2+, bit 0 = first-click-safe game),
+ *   varint move... where move = (cellIndex * 2 + action) + 1 (action 0 = reveal, 1 = flag toggle),
+ *   varint 0 (end of moves), varint result (IBoardSolver::GameState; PLAYING = abandoned).
+ * All varints are unsigned LEB128. A game cut off by a crash is still readable up to its last move.
+ */
+namespace replayLog {
+    constexpr char MAGIC[4] = {'M', 'S', 'R', 'P'};
+    constexpr std::uint8_t VERSION = 2;
+    constexpr std::uint8_t OLDEST_VERSION = 1; // Still readable; new games are never appended to it
+    constexpr std::uint64_t FIRST_CLICK_SAFE = 1;
+
+    struct Move {
+        int cellIndex;
+        IBoardSolver::ClickMode action;
+    };
+
+    struct GameRecord {
+        std::uint64_t seed = 0;
+        int gridSize = 0;
+        int mines = 0;
+        bool firstClickSafe = false; // Mines were placed by the first reveal
+        std::vector<Move> moves;
+        IBoardSolver::GameState result = IBoardSolver::PLAYING;
+        bool complete = false; // False if the log ended mid-game
+    };
+
+    void appendVarint(std::vector<std::uint8_t>& out, std::uint64_t value);
+}
+
+// Appends games to a replay file through an in-memory buffer
+class ReplayWriter {
+private:
+    static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::FILE* file = nullptr;
+    std::vector<std::uint8_t> buffer;
+    bool gameOpen = false;
+    
+    // A game's header is only written once its first move arrives, so boards that are
+    // reset before anyone plays them don't leave empty records behind
+    bool headerWritten = false;
+    std::uint64_t pendingSeed = 0;
+    int pendingGridSize = 0;
+    int pendingMines = 0;
+    bool pendingFirstClickSafe = false;
+
+public:
+    ReplayWriter() = default;
+    ~ReplayWriter();
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const std::string& path); // Appends; writes the header for new files and repairs crashed ones
+    bool isOpen() const { return file != nullptr; }
+    void close();
+    void flush();
+
+    void beginGame(std::uint64_t seed, int gridSize, int mines, bool firstClickSafe = false); // Closes any open game as abandoned
+    void recordMove(int cellIndex, IBoardSolver::ClickMode action);
+    void endGame(IBoardSolver::GameState result);
+
+private:
+    void flushIfFull();
+};
+
+// Streams games back out of a replay file
+class ReplayReader {
+private:
+    std::vector<std::uint8_t> data;
+    size_t position = 0;
+    std::uint8_t version = 0;
+    size_t cleanSize = 0; // Bytes up to the last complete game or move
+    bool truncatedGame = false; // Last game read was cut off after its header
+
+public:
+    bool open(const std::string& path);
+    bool nextGame(replayLog::GameRecord& record); // False once no more games are left
+    void rewind();
+    std::uint8_t getVersion() const { return version; }
+
+    // Crash recovery, valid after reading every game
+    size_t getCleanSize() const { return cleanSize; }
+    bool endsMidGame() const { return truncatedGame; }
+
+private:
+    bool readVarint(std::uint64_t& value);
+};
+
+/**
+ * Re-applies recorded games to a Board, either as fast as possible (headless)
+ * or at a fixed number of moves per second (GUI).
+ */
+class ReplayPlayer {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+private:
+    Board& board;
+    ReplayReader reader;
+    replayLog::GameRecord current;
+    size_t nextMove = 0;
+    bool hasGame = false;
+    int gamesLoaded = 0;
+    double movesPerSecond = 4.0;
+    TimePoint nextMoveTime;
+
+public:
+    ReplayPlayer(Board& board);
+
+    bool open(const std::string& path);
+    bool loadNextGame(); // Resets the board to the next recorded game
+    bool skipToGame(int index);
+
+    // Applies up to maxMoves moves of the current game; returns how many were applied
+    int step(int maxMoves);
+    // Applies every move due by now at the configured rate (GUI playback)
+    int advance();
+    std::optional<TimePoint> getNextMoveTime() const;
+
+    bool isGameFinished() const { return !hasGame || nextMove >= current.moves.size(); }
+    bool resultMatches() const; // Board ended in the recorded state
+    const replayLog::GameRecord& getCurrentGame() const { return current; }
+    int getGameNumber() const { return gamesLoaded; }
+
+    void setMovesPerSecond(double rate);
+    double getMovesPerSecond() const { return movesPerSecond; }
+};
+
+#endif
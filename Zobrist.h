@@ -0,0 +1,32 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+/**
+ * Zobrist keys for player-visible cell states.
+ * States use the getPlayerView() encoding (-2 flagged, -1 unknown, 0-8, 9 bomb).
+ * Keys are derived from (cell index, state) with splitmix64 instead of a random
+ * table, so they are identical for every board size and every run.
+ * Unknown cells hash to 0: a fresh board's hash is just its boardKey.
+ */
+namespace zobrist {
+    inline std::uint64_t mix(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    inline std::uint64_t cellKey(int index, int state) {
+        if (state == -1) return 0;
+        return mix((static_cast<std::uint64_t>(index) << 4) | static_cast<std::uint64_t>(state + 2));
+    }
+
+    // Distinguishes boards of different size / mine count that share a view
+    inline std::uint64_t boardKey(int gridSize, int mines) {
+        return mix(0xB0A2DULL ^ (static_cast<std::uint64_t>(gridSize) << 32) ^ static_cast<std::uint64_t>(mines));
+    }
+}
+
+#endif
@@ -1,9 +1,16 @@
 #include "IBoardSolver.h"
 #include "Board.h"
 #include "solverUtilities.cpp"
+#include "guessSearch.cpp"
+#include "patternTable.cpp"
+#include "gameRecorder.cpp"
+#include "GameStats.h"
 #include <queue>
 #include <set>
 #include <iostream>
+#include <chrono>
+#include <bitset>
+#include <cstdint>
 
 using namespace std;
 
@@ -14,15 +21,21 @@ private:
     IBoardSolver& gameBoard;
     BoardRenderer* renderer;
     bool firstMove = true;
-    sf::Clock moveClock;
+    std::chrono::steady_clock::time_point nextMoveTime; // When the next move is due
     float speed = 1.0f; // Speed multiplier (1.0 = normal, 2.0 = 2x faster, 0.5 = 2x slower)
     float baseMoveDelay = 0.5f; // Base delay between moves
     bool waitingToClick = false;
     sf::Clock clickDelay;
     float preClickDelay = 0.2f; // Show selection before clicking
     
+    bool turbo = false; // Batch/headless runs: no delay between moves
+    
     float getMoveDelay() const {
-        return baseMoveDelay / speed;
+        return turbo ? 0.0f : baseMoveDelay / speed;
+    }
+
+    void scheduleNextMove() {
+        solverUtilities::scheduleAfter(nextMoveTime, getMoveDelay());
     }
 
     queue<std::pair<int, int>> cellsToReveal;
@@ -36,10 +49,22 @@ private:
     int wins = 0;
     int losses = 0;
     bool gameWasCounted = false; // Prevent counting the same game multiple times
+    gameRecorder recorder;
     
     // Safe start mode
     bool safeStartEnabled = false;
 
+    // Searches guesses instead of picking blindly when no certain move exists
+    guessSearch guesser;
+
+    // Queues the searched guess; false if the position was too big to search in budget
+    bool queueSearchedGuess() {
+        pair<int, int> move;
+        if (!recorder.searchGuess(guesser, "[Algo]", move, nextRevealIsGuess)) return false;
+        queueRevealCell(move);
+        return !cellsToReveal.empty();
+    }
+
     void queueRevealCell(pair<int, int> cell) {
         // Don't queue if already revealed
         if (gameBoard.searchCell(cell.first, cell.second)) {
@@ -83,14 +108,16 @@ private:
         int oldX = gameBoard.getSelectedX();
         int oldY = gameBoard.getSelectedY();
         gameBoard.setSelectedCell(cell.first, cell.second);
-        renderer->startSelectionAnimation(oldX, oldY);
-        if (renderer && nextRevealIsGuess) {
-            renderer->setGuessMove(true);
+        if (renderer) renderer->startSelectionAnimation(oldX, oldY);
+        recorder.noteMove();
+        if (nextRevealIsGuess) {
+            recorder.noteGuess(cell.second * gameBoard.getGridSize() + cell.first);
+            if (renderer) renderer->setGuessMove(true);
             nextRevealIsGuess = false; // Reset flag after using it
         }
-        renderer->startClickAnimation();
+        if (renderer) renderer->startClickAnimation();
         gameBoard.algoClick();
-        moveClock.restart();
+        scheduleNextMove();
         return;
     }
 
@@ -105,10 +132,11 @@ private:
         int oldX = gameBoard.getSelectedX();
         int oldY = gameBoard.getSelectedY();
         gameBoard.setSelectedCell(cell.first, cell.second);
-        renderer->startSelectionAnimation(oldX, oldY);
-        renderer->startClickAnimation();
+        if (renderer) renderer->startSelectionAnimation(oldX, oldY);
+        recorder.noteMove();
+        if (renderer) renderer->startClickAnimation();
         gameBoard.algoClick();
-        moveClock.restart();
+        scheduleNextMove();
         return;
     }
 
@@ -129,6 +157,7 @@ private:
     void randomGuess() {
         vector<pair<int, int>> unrevealedCells = gameBoard.getAllUnrevealedCells();
         if (unrevealedCells.empty()) return; // No moves available
+        if (queueSearchedGuess()) return;
         pair<int, int> move = solverUtilities::makeRandomMove(unrevealedCells);
         nextRevealIsGuess = true; // Mark that the next reveal is a guess
         queueRevealCell(move);
@@ -244,16 +273,7 @@ private:
 
     void resetSolverState() {
         // Track game result before resetting
-        if (!gameWasCounted && gameBoard.isGameOver()) {
-            if (gameBoard.getGameState() == IBoardSolver::WON) {
-                wins++;
-                cout << "Game Won! Total: " << wins << " wins, " << losses << " losses" << endl;
-            } else if (gameBoard.getGameState() == IBoardSolver::LOST) {
-                losses++;
-                cout << "Game Lost! Total: " << wins << " wins, " << losses << " losses" << endl;
-            }
-            gameWasCounted = true;
-        }
+        countFinishedGame();
         
         // Preserve the active state so solver continues running after reset
         bool wasActive = algoActive;
@@ -274,6 +294,7 @@ private:
         }
         gameWasCounted = false; // Reset for next game
         nextRevealIsGuess = false; // Reset guess flag
+        recorder.start();
     }
 
     // Cell - flagged neighbors == 1 && unrev neighbors - flagged neighbors == 1
@@ -318,28 +339,107 @@ private:
         }
     }
 
+    // Unknown neighbors of (x, y) as bits of a 7x7 window centred on (cx, cy),
+    // bit (wy + 3) * 7 + (wx + 3); also returns the mines the number still needs
+    std::uint64_t neighborhoodMask(const vector<vector<int>>& view, int x, int y, int cx, int cy, int& need) const {
+        int gridSize = gameBoard.getGridSize();
+        std::uint64_t mask = 0;
+        need = view[x][y];
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= gridSize || ny < 0 || ny >= gridSize) continue;
+                if (view[nx][ny] == -2) need--;
+                if (view[nx][ny] != -1) continue;
+                mask |= std::uint64_t(1) << ((ny - cy + 3) * 7 + (nx - cx + 3));
+            }
+        }
+        return mask;
+    }
+
+    // Queue the first cell of a forced group; true if something was queued
+    bool queueForcedGroup(std::uint64_t group, bool mine, int cx, int cy) {
+        if (group == 0) return false;
+        int bit = 0;
+        while (!((group >> bit) & 1)) bit++;
+        pair<int, int> cell = {cx + bit % 7 - 3, cy + bit / 7 - 3};
+        cout << "[Algo] Pattern table: (" << cell.first << ", " << cell.second << ") is " << (mine ? "a mine" : "safe") << endl;
+        if (mine) queueFlagCell(cell);
+        else queueRevealCell(cell);
+        return !cellsToReveal.empty() || !cellsToFlag.empty();
+    }
+
+    // Table-driven deductions: every number alone and paired with each number in its
+    // 5x5 window, one lookup per pair (see patternTable.cpp)
+    void applyPatternTable() {
+        vector<vector<int>> view = gameBoard.getPlayerView();
+        int gridSize = gameBoard.getGridSize();
+        for (int x = 0; x < gridSize; x++) {
+            for (int y = 0; y < gridSize; y++) {
+                if (view[x][y] < 1 || view[x][y] > 8) continue;
+                int needA;
+                std::uint64_t maskA = neighborhoodMask(view, x, y, x, y, needA);
+                if (maskA == 0) continue;
+
+                for (int dy = -2; dy <= 2; dy++) {
+                    for (int dx = -2; dx <= 2; dx++) {
+                        int bx = x + dx;
+                        int by = y + dy;
+                        bool single = dx == 0 && dy == 0; // A on its own
+                        if (!single && (bx < 0 || bx >= gridSize || by < 0 || by >= gridSize)) continue;
+                        if (!single && (view[bx][by] < 1 || view[bx][by] > 8)) continue;
+                        int needB = 0;
+                        std::uint64_t maskB = single ? 0 : neighborhoodMask(view, bx, by, x, y, needB);
+                        if (!single && (maskA & maskB) == 0) continue; // Nothing shared, nothing to combine
+
+                        std::uint64_t onlyA = maskA & ~maskB;
+                        std::uint64_t shared = maskA & maskB;
+                        std::uint64_t onlyB = maskB & ~maskA;
+                        std::uint8_t result = patternTable::lookup(static_cast<int>(bitset<64>(onlyA).count()),
+                            static_cast<int>(bitset<64>(shared).count()), static_cast<int>(bitset<64>(onlyB).count()), needA, needB);
+                        if (result == 0 || result == patternTable::CONTRADICTION) continue;
+
+                        if (renderer) renderer->startInspection(x, y);
+                        if ((result & patternTable::ONLY_A_SAFE) && queueForcedGroup(onlyA, false, x, y)) return;
+                        if ((result & patternTable::SHARED_SAFE) && queueForcedGroup(shared, false, x, y)) return;
+                        if ((result & patternTable::ONLY_B_SAFE) && queueForcedGroup(onlyB, false, x, y)) return;
+                        if ((result & patternTable::ONLY_A_MINE) && queueForcedGroup(onlyA, true, x, y)) return;
+                        if ((result & patternTable::SHARED_MINE) && queueForcedGroup(shared, true, x, y)) return;
+                        if ((result & patternTable::ONLY_B_MINE) && queueForcedGroup(onlyB, true, x, y)) return;
+                    }
+                }
+            }
+        }
+    }
+
     void processGrid() {
         // Only run each function if both queues are still empty
         
+        // Pattern lookups cover the single-number rules below and pairs such as 1-2-1
+        if (cellsToReveal.empty() && cellsToFlag.empty()) {
+            recorder.deduce(GameMetrics::PATTERN_TABLE, cellsToReveal, cellsToFlag, [this]() { applyPatternTable(); });
+        }
+        
         // Flags
         if (cellsToReveal.empty() && cellsToFlag.empty()) {
-            flagCornersOfOnes();
+            recorder.deduce(GameMetrics::FILLED_NUMBER, cellsToReveal, cellsToFlag, [this]() { flagCornersOfOnes(); });
         }
         
         // Subtraction flagging
         if (cellsToReveal.empty() && cellsToFlag.empty()) {
-            subtractionFlagging();
+            recorder.deduce(GameMetrics::SUBTRACTION, cellsToReveal, cellsToFlag, [this]() { subtractionFlagging(); });
         }
 
         // Reveals
         if (cellsToReveal.empty() && cellsToFlag.empty()) {
-            revealSatisfiedCells();
+            recorder.deduce(GameMetrics::SATISFIED_NUMBER, cellsToReveal, cellsToFlag, [this]() { revealSatisfiedCells(); });
         }
     }
 
 public:
 
-    algoSolver(IBoardSolver& b, BoardRenderer* r) : gameBoard(b), renderer(r) {}
+    algoSolver(IBoardSolver& b, BoardRenderer* r) : gameBoard(b), renderer(r), recorder(b) {}
     
     void setSpeed(float newSpeed) {
         speed = std::max(0.1f, std::min(10.0f, newSpeed)); // Clamp between 0.1x and 10x
@@ -355,11 +455,51 @@ public:
     int getWins() const { return wins; }
     int getLosses() const { return losses; }
     int getTotalGames() const { return wins + losses; }
+    const GameStats& getStats() const { return recorder.getStats(); }
+    
+    // Counts a finished game once (wins/losses and its metrics); resets do this themselves
+    void countFinishedGame() {
+        if (gameWasCounted || !gameBoard.isGameOver()) return;
+        if (gameBoard.getGameState() == IBoardSolver::WON) {
+            wins++;
+            cout << "Game Won! Total: " << wins << " wins, " << losses << " losses" << endl;
+        } else if (gameBoard.getGameState() == IBoardSolver::LOST) {
+            losses++;
+            cout << "Game Lost! Total: " << wins << " wins, " << losses << " losses" << endl;
+        }
+        recorder.finish();
+        gameWasCounted = true;
+    }
     
     void setSafeStart(bool enabled) {
         safeStartEnabled = enabled;
     }
     
+    void setTurbo(bool enabled) {
+        turbo = enabled;
+    }
+    
+    // Per-guess search budget in milliseconds, 0 turns the search off
+    void setGuessBudget(double milliseconds) {
+        guesser.setBudget(milliseconds);
+    }
+    
+    // Threads the guess search may use for sampling and scoring (defaults to every core)
+    void setGuessThreads(int count) {
+        guesser.setThreads(count);
+    }
+    
+    // Counts guesses made while a provably safe cell existed (costs an exact analysis per guess)
+    void setOracle(bool enabled) {
+        recorder.setOracle(enabled);
+    }
+    
+    // Abandon the current game (if any) and start a fresh one, keeping the solver running
+    void restartGame() {
+        resetSolverState();
+        algoActive = true;
+    }
+    
     void start() {
         algoActive = true;
         cout << "[Algo] Solver started" << endl;
@@ -374,10 +514,19 @@ public:
     bool isActive() const {
         return algoActive;
     }
+    
+    // True while makeMove() still has something to do (playing, or a finished game to reset)
+    bool hasPendingWork() const {
+        return algoActive || gameBoard.isGameOver();
+    }
+    
+    std::chrono::steady_clock::time_point getNextMoveTime() const {
+        return nextMoveTime;
+    }
 
     void makeMove() {
         // Only make a move if enough time has passed
-        if (moveClock.getElapsedTime().asSeconds() < getMoveDelay()) {
+        if (std::chrono::steady_clock::now() < nextMoveTime) {
             return;
         }
 
@@ -426,7 +575,7 @@ public:
                 
                 // If processGrid found actions, perform them
                 if (preformNextAction()) {
-                    moveClock.restart();
+                    scheduleNextMove();
                     return;
                 }
                 
@@ -434,7 +583,7 @@ public:
                 cout << "No logical moves found after transition. Making random guess." << endl;
                 randomGuess();
                 if (preformNextAction()) {
-                    moveClock.restart();
+                    scheduleNextMove();
                     return;
                 }
                 
@@ -448,14 +597,14 @@ public:
             // Still in random guess phase, make a random guess
             randomGuess();
             preformNextAction();
-            moveClock.restart();
+            scheduleNextMove();
         } else {
             // We're in algorithm phase, queues are empty, so process grid again
             processGrid();
             
             // If processGrid found actions, perform them
             if (preformNextAction()) {
-                moveClock.restart();
+                scheduleNextMove();
                 return;
             }
             
@@ -463,7 +612,7 @@ public:
             cout << "No logical moves found. Making random guess." << endl;
             randomGuess();
             if (preformNextAction()) {
-                moveClock.restart();
+                scheduleNextMove();
                 return;
             }
             
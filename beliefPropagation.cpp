@@ -0,0 +1,319 @@
+#ifndef BELIEF_PROPAGATION_H
+#define BELIEF_PROPAGATION_H
+
+#include "IBoardSolver.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * Approximate mine probabilities for boards far too big to enumerate or sample.
+ *
+ * Loopy belief propagation on the factor graph of revealed numbers: every number
+ * sends each unknown neighbor a log-odds message computed exactly from the
+ * distribution of mines among its other neighbors, and a cell's belief is the
+ * global density prior plus its incoming messages. Minesweeper constraints are
+ * full of short loops that plain BP double-counts into confident wrong answers,
+ * so inferred messages are bounded and down-weighted by LOOP_WEIGHT; only
+ * structural deductions (a number already satisfied, or needing every neighbor)
+ * mark a cell as certain.
+ *
+ * Messages live in one flat float array, eight slots per cell (slot d of a number
+ * is the message to its neighbor in direction d), so there is no per-edge
+ * allocation. The engine follows the board's change journal: only numbers next to
+ * changed cells are rescheduled, and a message that moves by more than TOLERANCE
+ * reschedules the numbers around its cell. Each settle() call is bounded, so work
+ * per move stays proportional to what the move changed.
+ */
+class beliefPropagation {
+public:
+    static constexpr float TOLERANCE = 0.01f;  // Log-odds change that triggers neighbors
+    static constexpr float DAMPING = 0.3f;     // Share of the old message kept on update
+    static constexpr float CLAMP = 20.0f;      // Log-odds message for a structural deduction
+    static constexpr double SOFT_CLAMP = 8.0;  // Bound for inferred messages
+    static constexpr float LOOP_WEIGHT = 0.5f; // Scale on summed messages (fractional BP)
+
+private:
+    static constexpr std::int8_t UNKNOWN = -1;
+    static constexpr std::int8_t FLAGGED = -2;
+    static constexpr int DX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    static constexpr int DY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    // The opposite of direction d is 7 - d
+
+    int gridSize = 0;
+    int totalMines = 0;
+    std::vector<std::int8_t> view;     // Player-view encoding, flat
+    std::vector<float> messages;        // 8 per cell, number -> neighbor
+    std::vector<float> incoming;        // Sum of messages into each unknown cell
+    std::vector<std::uint8_t> forcedSafe; // Structural deductions received, per cell
+    std::vector<std::uint8_t> forcedMine;
+    std::vector<int> forcedCells;       // Cells that became forced, for popForced()
+    std::vector<std::uint8_t> queued;
+    std::vector<int> work;              // Numbers waiting to be recomputed (FIFO via head)
+    std::size_t workHead = 0;
+
+    // Unknown cells next to at least one number, with their slot in frontierCells
+    std::vector<int> frontierCells;
+    std::vector<int> frontierSlot;
+
+    int unknownCount = 0;
+    int flagCount = 0;
+    float priorLogOdds = 0.0f;
+
+    // Position in the board's change journal
+    unsigned int syncedEpoch = 0;
+    std::size_t syncedLogSize = 0;
+    bool built = false;
+
+public:
+    // Catch up with the board; returns true if the view changed
+    bool sync(const IBoardSolver& board) {
+        const std::vector<int>& changeLog = board.getChangeLog();
+        if (!built || board.getChangeEpoch() != syncedEpoch || board.getGridSize() != gridSize
+            || changeLog.size() < syncedLogSize) {
+            rebuild(board);
+            return true;
+        }
+        if (changeLog.size() == syncedLogSize) return false;
+
+        for (std::size_t i = syncedLogSize; i < changeLog.size(); i++) {
+            int index = changeLog[i];
+            int value = board.getViewState(index % gridSize, index / gridSize);
+            if (value != view[index]) applyCell(index, static_cast<std::int8_t>(value));
+        }
+        syncedLogSize = changeLog.size();
+        updatePrior();
+        return true;
+    }
+
+    // Recompute up to `maxUpdates` queued numbers; returns how many were done
+    int settle(int maxUpdates) {
+        int done = 0;
+        while (workHead < work.size() && done < maxUpdates) {
+            int number = work[workHead++];
+            queued[number] = 0;
+            updateNumber(number);
+            done++;
+        }
+        // Drop the consumed prefix so the queue doesn't grow while numbers keep requeueing
+        if (workHead == work.size() || workHead > work.size() / 2) {
+            work.erase(work.begin(), work.begin() + workHead);
+            workHead = 0;
+        }
+        return done;
+    }
+
+    bool isSettled() const { return workHead == work.size(); }
+
+    int getGridSize() const { return gridSize; }
+    bool isUnknown(int index) const { return view[index] == UNKNOWN; }
+    int getUnknownCount() const { return unknownCount; }
+    int getFlagCount() const { return flagCount; }
+    const std::vector<int>& getFrontier() const { return frontierCells; }
+    bool isFrontier(int index) const { return frontierSlot[index] >= 0; }
+
+    // Belief for an unknown cell; cells away from every number get the prior
+    double getMineProbability(int index) const {
+        if (forcedSafe[index]) return 0.0;
+        if (forcedMine[index]) return 1.0;
+        return 1.0 / (1.0 + std::exp(-(priorLogOdds + LOOP_WEIGHT * incoming[index])));
+    }
+    bool isForcedSafe(int index) const { return forcedSafe[index] && !forcedMine[index]; }
+    bool isForcedMine(int index) const { return forcedMine[index] && !forcedSafe[index]; }
+
+    // Next unknown cell with a structural deduction, or -1; saves scanning the frontier
+    int popForced() {
+        while (!forcedCells.empty()) {
+            int index = forcedCells.back();
+            forcedCells.pop_back();
+            if (isUnknown(index) && (isForcedSafe(index) || isForcedMine(index))) return index;
+        }
+        return -1;
+    }
+    double getOutsideProbability() const { return 1.0 / (1.0 + std::exp(-priorLogOdds)); }
+
+private:
+    void rebuild(const IBoardSolver& board) {
+        gridSize = board.getGridSize();
+        totalMines = board.getTotalMines();
+        int cellCount = gridSize * gridSize;
+        view.assign(cellCount, UNKNOWN);
+        messages.assign(static_cast<std::size_t>(cellCount) * 8, 0.0f);
+        incoming.assign(cellCount, 0.0f);
+        forcedSafe.assign(cellCount, 0);
+        forcedMine.assign(cellCount, 0);
+        forcedCells.clear();
+        queued.assign(cellCount, 0);
+        work.clear();
+        workHead = 0;
+        frontierCells.clear();
+        frontierSlot.assign(cellCount, -1);
+        unknownCount = cellCount;
+        flagCount = 0;
+
+        for (int index = 0; index < cellCount; index++) {
+            int value = board.getViewState(index % gridSize, index / gridSize);
+            if (value != UNKNOWN) applyCell(index, static_cast<std::int8_t>(value));
+        }
+        syncedEpoch = board.getChangeEpoch();
+        syncedLogSize = board.getChangeLog().size();
+        built = true;
+        updatePrior();
+    }
+
+    void updatePrior() {
+        int minesLeft = totalMines - flagCount;
+        double density = unknownCount > 0 ? static_cast<double>(minesLeft) / unknownCount : 0.0;
+        density = std::min(std::max(density, 1e-6), 1.0 - 1e-6);
+        priorLogOdds = static_cast<float>(std::log(density / (1.0 - density)));
+    }
+
+    bool isNumber(int index) const { return view[index] >= 0 && view[index] != IBoardSolver::BOMB; }
+
+    int neighborAt(int index, int direction) const {
+        int x = index % gridSize + DX[direction];
+        int y = index / gridSize + DY[direction];
+        if (x < 0 || x >= gridSize || y < 0 || y >= gridSize) return -1;
+        return y * gridSize + x;
+    }
+
+    void schedule(int number) {
+        if (queued[number]) return;
+        queued[number] = 1;
+        work.push_back(number);
+    }
+
+    void applyCell(int index, std::int8_t value) {
+        std::int8_t previous = view[index];
+        if (previous == UNKNOWN) unknownCount--;
+        if (previous == FLAGGED) flagCount--;
+        if (value == UNKNOWN) unknownCount++;
+        if (value == FLAGGED) flagCount++;
+
+        // A cell that stops being unknown drops the messages it was receiving
+        if (previous == UNKNOWN) {
+            for (int d = 0; d < 8; d++) {
+                int number = neighborAt(index, d);
+                if (number >= 0) setMessage(number, 7 - d, index, 0.0f);
+            }
+        }
+
+        view[index] = value;
+        updateFrontier(index);
+        if (isNumber(index)) schedule(index);
+        for (int d = 0; d < 8; d++) {
+            int neighbor = neighborAt(index, d);
+            if (neighbor < 0) continue;
+            updateFrontier(neighbor);
+            if (isNumber(neighbor)) schedule(neighbor);
+        }
+    }
+
+    void updateFrontier(int index) {
+        bool member = false;
+        if (view[index] == UNKNOWN) {
+            for (int d = 0; d < 8 && !member; d++) {
+                int neighbor = neighborAt(index, d);
+                member = neighbor >= 0 && isNumber(neighbor);
+            }
+        }
+        int slot = frontierSlot[index];
+        if (member && slot < 0) {
+            frontierSlot[index] = static_cast<int>(frontierCells.size());
+            frontierCells.push_back(index);
+        } else if (!member && slot >= 0) {
+            int last = frontierCells.back();
+            frontierCells[slot] = last;
+            frontierSlot[last] = slot;
+            frontierCells.pop_back();
+            frontierSlot[index] = -1;
+        }
+    }
+
+    void setMessage(int number, int direction, int cell, float value) {
+        float& message = messages[static_cast<std::size_t>(number) * 8 + direction];
+        if (message == -CLAMP) forcedSafe[cell]--;
+        if (message == CLAMP) forcedMine[cell]--;
+        incoming[cell] += value - message;
+        message = value;
+        if (value == -CLAMP && forcedSafe[cell]++ == 0) forcedCells.push_back(cell);
+        if (value == CLAMP && forcedMine[cell]++ == 0) forcedCells.push_back(cell);
+    }
+
+    // Recompute a number's messages from the beliefs of its unknown neighbors
+    void updateNumber(int number) {
+        if (!isNumber(number)) return;
+        int cells[8];
+        int directions[8];
+        double mine[8];
+        int count = 0;
+        int need = view[number];
+        for (int d = 0; d < 8; d++) {
+            int cell = neighborAt(number, d);
+            if (cell < 0) continue;
+            if (view[cell] == FLAGGED) need--;
+            if (view[cell] != UNKNOWN) continue;
+            // Cavity belief: everything the cell knows except this number's own message
+            float cavity = priorLogOdds + LOOP_WEIGHT * (incoming[cell] - messages[static_cast<std::size_t>(number) * 8 + d]);
+            cavity = std::min(std::max(cavity, -CLAMP), CLAMP);
+            cells[count] = cell;
+            directions[count] = d;
+            mine[count] = 1.0 / (1.0 + std::exp(-cavity));
+            count++;
+        }
+        if (count == 0) return;
+        bool consistent = need >= 0 && need <= count;
+
+        // Prefix and suffix distributions of the mine count, for leave-one-out products
+        double prefix[9][9] = {};
+        double suffix[10][9] = {};
+        prefix[0][0] = 1.0;
+        for (int i = 0; i < count; i++) {
+            for (int k = 0; k <= i + 1; k++) {
+                prefix[i + 1][k] = prefix[i][k] * (1.0 - mine[i]) + (k > 0 ? prefix[i][k - 1] * mine[i] : 0.0);
+            }
+        }
+        suffix[count][0] = 1.0;
+        for (int i = count - 1; i >= 0; i--) {
+            for (int k = 0; k <= count - i; k++) {
+                suffix[i][k] = suffix[i + 1][k] * (1.0 - mine[i]) + (k > 0 ? suffix[i + 1][k - 1] * mine[i] : 0.0);
+            }
+        }
+
+        for (int i = 0; i < count; i++) {
+            float target = 0.0f; // Neutral when the number is contradicted (e.g. a wrong flag)
+            if (consistent) {
+                // P(others hold need - 1) vs P(others hold need)
+                double withMine = 0.0;
+                double withoutMine = 0.0;
+                for (int a = 0; a <= i; a++) {
+                    int b = need - 1 - a;
+                    if (b >= 0 && b <= count - i - 1) withMine += prefix[i][a] * suffix[i + 1][b];
+                    b = need - a;
+                    if (b >= 0 && b <= count - i - 1) withoutMine += prefix[i][a] * suffix[i + 1][b];
+                }
+                if (withMine <= 0.0) target = -CLAMP;
+                else if (withoutMine <= 0.0) target = CLAMP;
+                else target = static_cast<float>(std::min(std::max(std::log(withMine / withoutMine), -SOFT_CLAMP), SOFT_CLAMP));
+            }
+
+            // Only structural deductions reach CLAMP; they are exact, so they skip damping
+            float& message = messages[static_cast<std::size_t>(number) * 8 + directions[i]];
+            float updated = std::abs(target) == CLAMP ? target : DAMPING * message + (1.0f - DAMPING) * target;
+            float change = updated - message;
+            if (change == 0.0f) continue;
+            setMessage(number, directions[i], cells[i], updated);
+            if (std::abs(change) < TOLERANCE) continue;
+
+            // The cell's belief moved: the other numbers around it must hear about it
+            for (int d = 0; d < 8; d++) {
+                int other = neighborAt(cells[i], d);
+                if (other >= 0 && other != number && isNumber(other)) schedule(other);
+            }
+        }
+    }
+};
+
+#endif
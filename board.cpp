@@ -1,14 +1,14 @@
 #include "Board.h"
-#include "solverUtilities.cpp"
+#include "ReplayLog.h"
+#include "Zobrist.h"
 #include <iostream>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace std;
 
-Board::Board() : gridData(GRID_SIZE, vector<CellVal>(GRID_SIZE, ZERO)), 
-                 revealedGrid(GRID_SIZE, vector<bool>(GRID_SIZE, false)),
-                 flaggedGrid(GRID_SIZE, vector<bool>(GRID_SIZE, false)) {
-    spawnMines();
-    solveForCellValues();
+Board::Board(int size, int mines) : gridSize(size), totalMines(mines), seedRng(random_device{}()) {
+    reset();
 }
 
 void Board::moveLeft() {
@@ -18,7 +18,7 @@ void Board::moveLeft() {
 }
 
 void Board::moveRight() {
-    if (selectedX < GRID_SIZE - 1) {
+    if (selectedX < gridSize - 1) {
         selectedX++;
     }
 }
@@ -30,7 +30,7 @@ void Board::moveUp() {
 }
 
 void Board::moveDown() {
-    if (selectedY < GRID_SIZE - 1) {
+    if (selectedY < gridSize - 1) {
         selectedY++;
     }
 }
@@ -40,36 +40,66 @@ int Board::getCellVal(int x, int y) const {
 }
 
 bool Board::isRevealed(int x, int y) const {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return false;
+    if (x < 0 || x >= gridSize || y < 0 || y >= gridSize) return false;
     return revealedGrid[x][y];
 }
 
 bool Board::isFlagged(int x, int y) const {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return false;
+    if (x < 0 || x >= gridSize || y < 0 || y >= gridSize) return false;
     return flaggedGrid[x][y];
 }
 
 void Board::revealCell(int x, int y) {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return;
+    if (x < 0 || x >= gridSize || y < 0 || y >= gridSize) return;
     if (revealedGrid[x][y]) return; // Already revealed
     if (currentGameState != PLAYING) return; // Game is over
+
+    if (minesPending) {
+        mineRng.seed(gameSeed); // Layout depends only on the seed and this cell, however we got here
+        spawnMines(x, y);
+        solveForCellValues();
+        minesPending = false;
+        measureDifficulty();
+    }
     
+    hashCell(x, y);
     revealedGrid[x][y] = true;
+    hashCell(x, y);
+    markChanged(x, y);
     cout << "Revealed cell (" << x << ", " << y << ") with value: " << static_cast<int>(gridData[x][y]) << endl;
     
     // If hit a bomb, game over
     if (gridData[x][y] == BOMB) {
-        currentGameState = LOST;
         revealAllMines();
+        endGame(LOST);
         return;
     }
+    revealedSafeCount++;
     
     // Flood fill for empty cells (value 0)
+    // Uses an explicit stack so large openings can't overflow the call stack
     if (gridData[x][y] == ZERO) {
-        for (int dx = -1; dx <= 1; dx++) {
-            for (int dy = -1; dy <= 1; dy++) {
-                if (dx == 0 && dy == 0) continue;
-                revealCell(x + dx, y + dy);
+        vector<pair<int, int>> pending = {{x, y}};
+        while (!pending.empty()) {
+            auto [cx, cy] = pending.back();
+            pending.pop_back();
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if (dx == 0 && dy == 0) continue;
+                    int nx = cx + dx;
+                    int ny = cy + dy;
+                    if (nx < 0 || nx >= gridSize || ny < 0 || ny >= gridSize) continue;
+                    if (revealedGrid[nx][ny]) continue;
+                    
+                    hashCell(nx, ny);
+                    revealedGrid[nx][ny] = true;
+                    hashCell(nx, ny);
+                    markChanged(nx, ny);
+                    revealedSafeCount++;
+                    if (gridData[nx][ny] == ZERO) {
+                        pending.emplace_back(nx, ny);
+                    }
+                }
             }
         }
     }
@@ -79,10 +109,13 @@ void Board::revealCell(int x, int y) {
 }
 
 void Board::revealAllMines() {
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
-            if (gridData[x][y] == BOMB) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
+            if (gridData[x][y] == BOMB && !revealedGrid[x][y]) {
+                hashCell(x, y);
                 revealedGrid[x][y] = true;
+                hashCell(x, y);
+                markChanged(x, y);
             }
         }
     }
@@ -92,23 +125,34 @@ void Board::checkWinCondition() {
     if (currentGameState != PLAYING) return;
     
     // Win if all non-mine cells are revealed
-    int revealedCount = 0;
-    int totalNonMineCells = (GRID_SIZE * GRID_SIZE) - totalMines;
-    
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
-            if (revealedGrid[x][y] && gridData[x][y] != BOMB) {
-                revealedCount++;
-            }
-        }
-    }
+    int totalNonMineCells = (gridSize * gridSize) - totalMines;
     
-    if (revealedCount == totalNonMineCells) {
-        currentGameState = WON;
+    if (revealedSafeCount == totalNonMineCells) {
+        endGame(WON);
         cout << "You won!" << endl;
     }
 }
 
+void Board::endGame(GameState state) {
+    currentGameState = state;
+    if (recorder) recorder->endGame(state);
+}
+
+void Board::markChanged(int x, int y) {
+    changeLog.push_back(cellIndex(x, y));
+}
+
+int Board::getViewState(int x, int y) const {
+    if (revealedGrid[x][y]) return static_cast<int>(gridData[x][y]);
+    return flaggedGrid[x][y] ? -2 : -1;
+}
+
+// XORs the cell's current visible state in or out of the view hash;
+// called once before and once after every visible change
+void Board::hashCell(int x, int y) {
+    viewHash ^= zobrist::cellKey(cellIndex(x, y), getViewState(x, y));
+}
+
 void Board::handleClick(int x, int y) {
     selectedX = x;
     selectedY = y;
@@ -116,6 +160,8 @@ void Board::handleClick(int x, int y) {
     // If game is over, don't process clicks
     if (currentGameState != PLAYING) return;
     
+    if (recorder) recorder->recordMove(cellIndex(x, y), currentClickMode);
+    
     cout << "Clicked on cell: (" << x << ", " << y << ")\n Click mode: " 
          << (currentClickMode == REVEAL ? "REVEAL" : "FLAG") << " Cell value: " 
          << static_cast<int>(gridData[x][y]) << endl;
@@ -128,7 +174,10 @@ void Board::handleClick(int x, int y) {
     } else {
         // Can't flag a revealed cell
         if (!revealedGrid[x][y]) {
+            hashCell(x, y);
             flaggedGrid[x][y] = !flaggedGrid[x][y];
+            hashCell(x, y);
+            markChanged(x, y);
             cout << (flaggedGrid[x][y] ? "Flagged" : "Unflagged") << " cell (" << x << ", " << y << ")" << endl;
         }
     }
@@ -141,12 +190,23 @@ void Board::toggleClickMode() {
         currentClickMode = REVEAL;
 }
 
-void Board::spawnMines() {
+void Board::spawnMines(int safeX, int safeY) {
     int minesToSpawn = totalMines;
 
+    // Keep the first click's neighborhood clear when there is room, else just the cell itself
+    int cellCount = gridSize * gridSize;
+    int safeRadius = -1;
+    if (safeX >= 0) {
+        int neighborhood = (min(safeX + 1, gridSize - 1) - max(safeX - 1, 0) + 1) * (min(safeY + 1, gridSize - 1) - max(safeY - 1, 0) + 1);
+        if (totalMines <= cellCount - neighborhood) safeRadius = 1;
+        else if (totalMines < cellCount) safeRadius = 0;
+    }
+
+    // Drawn from the game's own generator so the seed (and first click) reproduce the layout
     while (minesToSpawn > 0) {
-        int x = solverUtilities::getRandomInt(0, GRID_SIZE - 1);
-        int y = solverUtilities::getRandomInt(0, GRID_SIZE - 1);
+        int x = static_cast<int>(mineRng() % gridSize);
+        int y = static_cast<int>(mineRng() % gridSize);
+        if (safeRadius >= 0 && abs(x - safeX) <= safeRadius && abs(y - safeY) <= safeRadius) continue;
 
         if (gridData[x][y] != BOMB) {
             gridData[x][y] = BOMB; 
@@ -156,8 +216,8 @@ void Board::spawnMines() {
 }
 
 void Board::solveForCellValues() {
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
             if (gridData[x][y] == BOMB) continue; 
 
             int mineCount = 0;
@@ -174,29 +234,200 @@ void Board::solveForCellValues() {
     }
 }
 
+// Works on a flat copy of the grid framed by a border of mines, so every cell has 8
+// neighbors at fixed offsets. One pass in index order: each zero starts an opening,
+// is merged (union-find) with zeros already visited next to it, and marks its
+// neighbors as cleared by that opening. Numbers nobody marks need a click each.
+void Board::measureDifficulty() {
+    int stride = gridSize + 2;
+    flatCells.assign(stride * stride, BOMB);
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
+            flatCells[(y + 1) * stride + x + 1] = static_cast<uint8_t>(gridData[x][y]);
+        }
+    }
+    openingParent.assign(stride * stride, -1);
+    nearOpening.assign(stride * stride, 0);
+    auto root = [this](int index) {
+        while (openingParent[index] != index) {
+            openingParent[index] = openingParent[openingParent[index]];
+            index = openingParent[index];
+        }
+        return index;
+    };
+
+    const int offsets[8] = {-stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1};
+    int openings = 0, numbers = 0, borderNumbers = 0;
+    for (int index = stride + 1; index < stride * (stride - 1) - 1; index++) {
+        uint8_t value = flatCells[index];
+        if (value == BOMB) continue; // Also the frame
+        if (value != ZERO) {
+            numbers++;
+            continue;
+        }
+        openingParent[index] = index;
+        openings++;
+        for (int offset : offsets) {
+            int neighbor = index + offset;
+            uint8_t around = flatCells[neighbor];
+            if (around != ZERO) {
+                if (around != BOMB && !nearOpening[neighbor]) {
+                    nearOpening[neighbor] = 1;
+                    borderNumbers++;
+                }
+            } else if (openingParent[neighbor] >= 0) {
+                int a = root(index), b = root(neighbor);
+                if (a == b) continue;
+                openingParent[a] = b;
+                openings--;
+            }
+        }
+    }
+    difficulty.openings = openings;
+    difficulty.isolatedNumbers = numbers - borderNumbers;
+    difficulty.threeBV = openings + difficulty.isolatedNumbers;
+}
+
 bool Board::isMine(int x, int y) {
-    if (x < 0 || x > GRID_SIZE - 1 || y < 0 || y > GRID_SIZE - 1)
+    if (x < 0 || x > gridSize - 1 || y < 0 || y > gridSize - 1)
         return false;
     return gridData[x][y] == BOMB;
 }
 
 void Board::reset() {
-    gridData = vector<vector<CellVal>>(GRID_SIZE, vector<CellVal>(GRID_SIZE, ZERO));
-    revealedGrid = vector<vector<bool>>(GRID_SIZE, vector<bool>(GRID_SIZE, false));
-    flaggedGrid = vector<vector<bool>>(GRID_SIZE, vector<bool>(GRID_SIZE, false));
-    spawnMines();
+    // An external layout source (e.g. a board corpus) loads the next game itself
+    if (layoutSource && layoutSource(*this)) return;
+    reset(nextSeed());
+}
+
+void Board::reset(uint64_t seed) {
+    clearForNewGame(seed);
+    if (firstClickSafe) {
+        minesPending = true; // Placed by the first reveal
+    } else {
+        spawnMines();
+        solveForCellValues();
+        measureDifficulty();
+    }
+    startGame();
+}
+
+void Board::loadLayout(uint64_t seed, const uint64_t* mineBits) {
+    clearForNewGame(seed);
+    int placed = 0;
+    for (int index = 0; index < gridSize * gridSize; index++) {
+        if ((mineBits[index / 64] >> (index % 64)) & 1) {
+            gridData[index % gridSize][index / gridSize] = BOMB;
+            placed++;
+        }
+    }
+    totalMines = placed;
     solveForCellValues();
+    measureDifficulty();
+    startGame();
+}
+
+void Board::getMineBits(vector<uint64_t>& mineBits) const {
+    mineBits.assign((gridSize * gridSize + 63) / 64, 0);
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
+            if (gridData[x][y] == BOMB) {
+                int index = cellIndex(x, y);
+                mineBits[index / 64] |= uint64_t(1) << (index % 64);
+            }
+        }
+    }
+}
+
+void Board::exportGame(Prepared& game) {
+    game.seed = gameSeed;
+    game.gridSize = gridSize;
+    game.totalMines = totalMines;
+    game.minesPending = minesPending;
+    game.difficulty = difficulty;
+    game.rng = mineRng;
+    gridData.swap(game.gridData);
+    revealedGrid.swap(game.revealedGrid);
+    flaggedGrid.swap(game.flaggedGrid);
+}
+
+bool Board::adoptGame(Prepared& game) {
+    if (game.gridSize != gridSize || game.totalMines != totalMines || game.minesPending != firstClickSafe) return false;
+    // Swapped rather than moved: the old grids leave with the slot and are freed off this thread
+    gameSeed = game.seed;
+    mineRng = game.rng;
+    minesPending = game.minesPending;
+    difficulty = game.difficulty;
+    startCell = -1;
+    gridData.swap(game.gridData);
+    revealedGrid.swap(game.revealedGrid);
+    flaggedGrid.swap(game.flaggedGrid);
+    startGame();
+    return true;
+}
+
+void Board::clearForNewGame(uint64_t seed) {
+    gameSeed = seed;
+    mineRng.seed(seed); // Also drives the safe-start cell, so it follows the seed
+    minesPending = false;
+    startCell = -1;
+    difficulty = Difficulty();
+    gridData = vector<vector<CellVal>>(gridSize, vector<CellVal>(gridSize, ZERO));
+    revealedGrid = vector<vector<bool>>(gridSize, vector<bool>(gridSize, false));
+    flaggedGrid = vector<vector<bool>>(gridSize, vector<bool>(gridSize, false));
+}
+
+void Board::startGame() {
+    revealedSafeCount = 0;
+    viewHash = zobrist::boardKey(gridSize, totalMines); // Every cell starts unknown
+    changeLog.clear();
+    changeEpoch++;
     selectedX = 0;
     selectedY = 0;
     currentClickMode = REVEAL;
     currentGameState = PLAYING;
+    if (recorder) recorder->beginGame(gameSeed, gridSize, totalMines, minesPending);
+}
+
+void Board::newGame(int size, int mines, uint64_t seed) {
+    gridSize = size;
+    totalMines = mines;
+    reset(seed);
+}
+
+uint64_t Board::nextSeed() {
+    return seedSource ? seedSource() : seedRng();
+}
+
+void Board::setRecorder(ReplayWriter* writer) {
+    recorder = writer;
+    if (recorder) recorder->beginGame(gameSeed, gridSize, totalMines, minesPending);
 }
 
 void Board::revealRandomZero() {
+    // The layout says where it opens
+    if (startCell >= 0 && !revealedGrid[startCell % gridSize][startCell / gridSize]) {
+        int x = startCell % gridSize, y = startCell / gridSize;
+        cout << "Safe start: opening start cell (" << x << ", " << y << ")" << endl;
+        if (recorder) recorder->recordMove(startCell, REVEAL);
+        revealCell(x, y);
+        return;
+    }
+
+    // Mines not placed yet: any cell becomes a zero by clicking it first
+    if (minesPending) {
+        int index = static_cast<int>(mineRng() % (gridSize * gridSize));
+        int x = index % gridSize, y = index / gridSize;
+        cout << "Safe start: first click at (" << x << ", " << y << ")" << endl;
+        if (recorder) recorder->recordMove(index, REVEAL);
+        revealCell(x, y);
+        return;
+    }
+
     // Find all zero cells
     vector<pair<int, int>> zeroCells;
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
             if (gridData[x][y] == ZERO) {
                 zeroCells.push_back({x, y});
             }
@@ -205,9 +436,10 @@ void Board::revealRandomZero() {
     
     // If there are zero cells, reveal a random one
     if (!zeroCells.empty()) {
-        int randomIndex = solverUtilities::getRandomInt(0, zeroCells.size() - 1);
+        int randomIndex = static_cast<int>(mineRng() % zeroCells.size()); // Seeded, so replays and batch runs agree
         auto [x, y] = zeroCells[randomIndex];
         cout << "Safe start: revealing zero cell at (" << x << ", " << y << ")" << endl;
+        if (recorder) recorder->recordMove(cellIndex(x, y), REVEAL);
         revealCell(x, y);
     } else {
         cout << "No zero cells available for safe start!" << endl;
@@ -215,10 +447,10 @@ void Board::revealRandomZero() {
 }
 
 vector<vector<int>> Board::getPlayerView() const {
-    vector<vector<int>> playerView(GRID_SIZE, vector<int>(GRID_SIZE, -1)); // -1 for unrevealed
+    vector<vector<int>> playerView(gridSize, vector<int>(gridSize, -1)); // -1 for unrevealed
 
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
             if (revealedGrid[x][y]) {
                 playerView[x][y] = static_cast<int>(gridData[x][y]);
             } else if (flaggedGrid[x][y]) {
@@ -231,7 +463,7 @@ vector<vector<int>> Board::getPlayerView() const {
 }
 
 bool Board::setSelectedCell(int x, int y) {
-    if (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE) {
+    if (x >= 0 && x < gridSize && y >= 0 && y < gridSize) {
         selectedX = x;
         selectedY = y;
         return true;
@@ -246,7 +478,7 @@ bool Board::algoClick() {
 }
 
 bool Board::searchCell(int x, int y) const {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return false;
+    if (x < 0 || x >= gridSize || y < 0 || y >= gridSize) return false;
     return revealedGrid[x][y];
 }
 
@@ -256,8 +488,8 @@ bool Board::isGameOver() const {
 
 vector<pair<int, int>> Board::getAllUnrevealedCells() const {
     vector<pair<int, int>> revealedCells;
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
             if (!revealedGrid[x][y]) {
                 revealedCells.emplace_back(x, y);
             }
@@ -272,8 +504,8 @@ void Board::setClickMode(ClickMode mode) {
 
 vector<pair<int, int>> Board::getAllFlaggedCells() const {
     vector<pair<int, int>> flaggedCells;
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
             if (flaggedGrid[x][y]) {
                 flaggedCells.emplace_back(x, y);
             }
@@ -289,7 +521,7 @@ vector<pair<int, int>> Board::getUnrevealedNeighbors(int x, int y) const {
             if (dx == 0 && dy == 0) continue;
             int nx = x + dx;
             int ny = y + dy;
-            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE) {
+            if (nx >= 0 && nx < gridSize && ny >= 0 && ny < gridSize) {
                 if (!revealedGrid[nx][ny]) {
                     neighbors.emplace_back(nx, ny);
                 }
@@ -306,7 +538,7 @@ vector<pair<int, int>> Board::getFlaggedNeighbors(int x, int y) const {
             if (dx == 0 && dy == 0) continue;
             int nx = x + dx;
             int ny = y + dy;
-            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE) {
+            if (nx >= 0 && nx < gridSize && ny >= 0 && ny < gridSize) {
                 if (flaggedGrid[nx][ny]) {
                     neighbors.emplace_back(nx, ny);
                 }
@@ -318,8 +550,8 @@ vector<pair<int, int>> Board::getFlaggedNeighbors(int x, int y) const {
 
 vector<pair<int, int>> Board::getOnes() const {
     vector<pair<int, int>> ones;
-    for (int x = 0; x < GRID_SIZE; x++) {
-        for (int y = 0; y < GRID_SIZE; y++) {
+    for (int x = 0; x < gridSize; x++) {
+        for (int y = 0; y < gridSize; y++) {
             if (gridData[x][y] == ONE) {
                 ones.emplace_back(x, y);
             }
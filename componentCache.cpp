@@ -0,0 +1,178 @@
+#ifndef COMPONENT_CACHE_H
+#define COMPONENT_CACHE_H
+
+#include "BoardSnapshot.h"
+#include "transferMatrix.cpp"
+#include <vector>
+#include <string>
+#include <list>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * Bounded LRU memo of solved frontier components, kept across positions and games.
+ *
+ * The key is a canonical signature: the component's unknown cells and the mines its
+ * numbers still need, relative to its bounding box and taken in whichever of the 8
+ * rotations/reflections sorts first. The same little wall or corner anywhere on any
+ * board, in any orientation, maps to one entry. Results are stored in canonical cell
+ * order and mapped back through the permutation the signature came with.
+ *
+ * Counts cover every possible mine total, so the global mine count is applied by the
+ * caller afterwards and never has to be part of the key.
+ * One cache per thread; nothing is shared, so no locking.
+ */
+class componentCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20; // Stored solutions (or count entries) across all entries
+
+    struct Signature {
+        std::string key;
+        std::vector<int> order; // Canonical cell i is component cell order[i]
+    };
+
+    // Solved component in canonical cell order
+    struct Entry {
+        std::vector<std::uint64_t> solutions;
+        std::vector<int> solutionMines;
+        bool counted = false;
+        transferMatrix::Counts counts;
+    };
+
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t held = 0;
+
+        double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+private:
+    using Slot = std::pair<std::string, Entry>;
+
+    std::list<Slot> recent; // Most recently used first
+    std::unordered_map<std::string, std::list<Slot>::iterator> index;
+    size_t capacity = DEFAULT_CAPACITY;
+    Stats stats;
+
+    static size_t cost(const Entry& entry) {
+        if (!entry.counted) return entry.solutions.size() + 1;
+        return (entry.counts.cellByMines.size() + 1) * entry.counts.byMines.size() + 1;
+    }
+
+    void evict() {
+        while (stats.held > capacity && !recent.empty()) {
+            stats.held -= cost(recent.back().second);
+            index.erase(recent.back().first);
+            recent.pop_back();
+            stats.evictions++;
+        }
+        stats.entries = recent.size();
+    }
+
+public:
+    static componentCache& local() {
+        thread_local componentCache cache;
+        return cache;
+    }
+
+    static Signature signature(const BoardSnapshot& snapshot, const BoardSnapshot::FrontierComponent& part) {
+        int gridSize = snapshot.getGridSize();
+
+        // Cells as (x, y, code): 0 for an unknown, 2 + remaining need for a number (1 if overdrawn)
+        struct Point {
+            int x, y, code, cell;
+        };
+        std::vector<Point> points;
+        points.reserve(part.unknowns.size() + part.numbers.size());
+        for (size_t i = 0; i < part.unknowns.size(); i++) {
+            int index = part.unknowns[i];
+            points.push_back({index % gridSize, index / gridSize, 0, static_cast<int>(i)});
+        }
+        int neighbors[8];
+        for (int number : part.numbers) {
+            int need = snapshot.get(number);
+            int count = snapshot.getNeighbors(number, neighbors);
+            for (int i = 0; i < count; i++) {
+                if (snapshot.get(neighbors[i]) == BoardSnapshot::FLAGGED) need--;
+            }
+            points.push_back({number % gridSize, number / gridSize, 2 + std::max(-1, need), -1});
+        }
+
+        Signature best;
+        std::vector<Point> moved(points.size());
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            int minX = INT_MAX, minY = INT_MAX;
+            for (size_t i = 0; i < points.size(); i++) {
+                int x = points[i].x, y = points[i].y;
+                if (symmetry & 4) std::swap(x, y);
+                if (symmetry & 1) x = -x;
+                if (symmetry & 2) y = -y;
+                moved[i] = {x, y, points[i].code, points[i].cell};
+                minX = std::min(minX, x);
+                minY = std::min(minY, y);
+            }
+            std::sort(moved.begin(), moved.end(), [](const Point& a, const Point& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+
+            // Two bytes of offset from the box corner and one of code per cell
+            std::string key;
+            key.reserve(moved.size() * 5);
+            for (const Point& point : moved) {
+                int dx = point.x - minX, dy = point.y - minY;
+                key.push_back(static_cast<char>(dx & 255));
+                key.push_back(static_cast<char>(dx >> 8));
+                key.push_back(static_cast<char>(dy & 255));
+                key.push_back(static_cast<char>(dy >> 8));
+                key.push_back(static_cast<char>(point.code));
+            }
+            if (symmetry > 0 && key >= best.key) continue;
+            best.key = std::move(key);
+            best.order.clear();
+            for (const Point& point : moved) {
+                if (point.cell >= 0) best.order.push_back(point.cell);
+            }
+        }
+        return best;
+    }
+
+    const Entry* find(const std::string& key) {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            stats.misses++;
+            return nullptr;
+        }
+        stats.hits++;
+        recent.splice(recent.begin(), recent, found->second);
+        return &found->second->second;
+    }
+
+    void insert(const std::string& key, Entry entry) {
+        if (cost(entry) > capacity / 16) return; // One huge component shouldn't flush everything else
+        if (index.count(key)) return;
+        stats.held += cost(entry);
+        recent.emplace_front(key, std::move(entry));
+        index[key] = recent.begin();
+        evict();
+    }
+
+    void setCapacity(size_t held) {
+        capacity = held;
+        evict();
+    }
+
+    void clear() {
+        recent.clear();
+        index.clear();
+        stats.held = 0;
+        stats.entries = 0;
+    }
+
+    size_t getCapacity() const { return capacity; }
+    const Stats& getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,498 @@
+#ifndef CONSTRAINT_SOLVER_H
+#define CONSTRAINT_SOLVER_H
+
+#include "IBoardSolver.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * Persistent CDCL solver over the revealed numbers, for proving cells safe or mined.
+ *
+ * Variables are cells (1 = mine). Each revealed number is a native "exactly k of my
+ * neighbors" constraint propagated with true/false counters; revealed cells and flags
+ * are level-0 facts. Conflicts are explained through those constraints and learned as
+ * ordinary clauses (first UIP), which stay valid for the rest of the game because the
+ * view only ever gains information. The solver follows the board's change journal,
+ * so a move adds a handful of facts and constraints instead of rebuilding anything.
+ *
+ * Queries run under an assumption ("could this cell be a mine?") with a conflict
+ * budget; refuting an assumption usually leaves a level-0 unit behind, so later
+ * queries about the same cell are free. Only local constraints are used (not the
+ * global mine count), so every answer is sound but not always complete.
+ */
+class constraintSolver {
+public:
+    enum Answer { IMPOSSIBLE, POSSIBLE, UNDECIDED };
+
+    static const int DEFAULT_CONFLICT_BUDGET = 200; // Per query
+    static const size_t MAX_LEARNED = 20000;        // Longest half is dropped beyond this
+
+private:
+    static constexpr std::int8_t UNKNOWN = -1;
+    static constexpr std::int8_t FLAGGED = -2;
+    static constexpr std::int8_t UNASSIGNED = -1;
+    static constexpr int NO_REASON = -1;
+
+    struct Constraint {
+        int need = 0;
+        int size = 0;
+        int cells[8];
+        int trueCount = 0;
+        int falseCount = 0;
+    };
+
+    int gridSize = 0;
+    int conflictBudget = DEFAULT_CONFLICT_BUDGET;
+    std::vector<std::int8_t> view;
+
+    // Assignment; literal 2 * v + s means "cell v has value s"
+    std::vector<std::int8_t> value;
+    std::vector<int> level;
+    std::vector<int> reason;     // Clause id, or -2 - constraint id, or NO_REASON
+    std::vector<int> trailPos;
+    std::vector<int> trail;
+    std::vector<size_t> trailLimits;
+    size_t queueHead = 0;
+
+    std::vector<Constraint> constraints;
+    std::vector<int> constraintOf;          // Per cell: its number's constraint, or -1
+    std::vector<std::vector<int>> clauses;  // Learned only
+    std::vector<std::vector<int>> watches;  // Per literal: clauses watching it
+
+    std::vector<int> vars;                  // Cells in at least one constraint
+    std::vector<std::uint8_t> isVar;
+    std::vector<double> activity;
+    double activityStep = 1.0;
+    std::vector<std::int8_t> phase;         // Saved phase, also the last model found
+    std::vector<std::uint8_t> seen;
+
+    bool contradiction = false;             // The view itself is inconsistent (e.g. a wrong flag)
+    long long conflicts = 0;
+
+    // Position in the board's change journal
+    unsigned int syncedEpoch = 0;
+    size_t syncedLogSize = 0;
+    bool built = false;
+
+public:
+    void setConflictBudget(int budget) { conflictBudget = std::max(1, budget); }
+    long long getConflicts() const { return conflicts; }
+    size_t getLearnedCount() const { return clauses.size(); }
+    bool isContradictory() const { return contradiction; }
+
+    // Catch up with the board; returns true if the view changed
+    bool sync(const IBoardSolver& board) {
+        const std::vector<int>& changeLog = board.getChangeLog();
+        if (!built || board.getChangeEpoch() != syncedEpoch || board.getGridSize() != gridSize
+            || changeLog.size() < syncedLogSize) {
+            rebuild(board);
+            return true;
+        }
+        if (changeLog.size() == syncedLogSize) return false;
+
+        for (size_t i = syncedLogSize; i < changeLog.size(); i++) {
+            int index = changeLog[i];
+            int state = board.getViewState(index % gridSize, index / gridSize);
+            if (state == view[index]) continue;
+            if (view[index] == FLAGGED) {
+                // Removing a flag takes back a fact learned clauses may rest on
+                rebuild(board);
+                return true;
+            }
+            apply(index, static_cast<std::int8_t>(state));
+        }
+        syncedLogSize = changeLog.size();
+        if (!contradiction && !propagate().empty()) contradiction = true;
+        return true;
+    }
+
+    // Could the cell hold `mine` given every revealed number? IMPOSSIBLE is a proof
+    Answer canBe(int cell, bool mine) {
+        if (contradiction) return UNDECIDED;
+        if (!isVar[cell]) return POSSIBLE; // No number constrains it
+        int wanted = mine ? 1 : 0;
+        long long limit = conflicts + conflictBudget;
+
+        while (true) {
+            if (trailLimits.empty()) {
+                // Settle level 0 first so learned units stay level-0 facts
+                if (!propagate().empty()) {
+                    contradiction = true;
+                    return UNDECIDED;
+                }
+                if (value[cell] != UNASSIGNED) return value[cell] == wanted ? POSSIBLE : IMPOSSIBLE;
+                trailLimits.push_back(trail.size());
+                assign(cell, wanted, NO_REASON);
+            }
+
+            std::vector<int> conflict = propagate();
+            if (!conflict.empty()) {
+                conflicts++;
+                if (!learn(conflict)) {
+                    contradiction = true;
+                    return UNDECIDED;
+                }
+                if (conflicts >= limit) {
+                    backtrack(0);
+                    return UNDECIDED;
+                }
+                continue;
+            }
+
+            int next = pickBranch();
+            if (next < 0) {
+                for (int v : vars) phase[v] = value[v];
+                backtrack(0);
+                return POSSIBLE;
+            }
+            trailLimits.push_back(trail.size());
+            assign(next, phase[next], NO_REASON);
+        }
+    }
+
+    // Value of the cell in the last model found
+    bool modelSaysMine(int cell) const { return phase[cell] == 1; }
+
+    // First unknown cell proven safe or mined; -1 if none could be proven in budget.
+    // Candidates are filtered through models: a cell that differs between two
+    // models can't be forced, so most cells never need their own query
+    int findForcedCell(bool& mine) {
+        if (contradiction) return -1;
+        std::vector<int> candidates;
+        for (int v : vars) {
+            if (view[v] != UNKNOWN) continue;
+            if (value[v] != UNASSIGNED) {
+                mine = value[v] == 1; // Already a level-0 consequence
+                return v;
+            }
+            candidates.push_back(v);
+        }
+        if (candidates.empty()) return -1;
+        if (canBe(candidates.front(), phase[candidates.front()] == 1) != POSSIBLE) {
+            if (value[candidates.front()] != UNASSIGNED) {
+                mine = value[candidates.front()] == 1;
+                return candidates.front();
+            }
+            return -1;
+        }
+
+        std::vector<std::int8_t> reference(candidates.size());
+        for (size_t i = 0; i < candidates.size(); i++) reference[i] = phase[candidates[i]];
+        std::vector<std::uint8_t> excluded(candidates.size(), 0);
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (excluded[i]) continue;
+            int cell = candidates[i];
+            Answer answer = canBe(cell, reference[i] == 0);
+            if (answer == IMPOSSIBLE) {
+                mine = reference[i] == 1;
+                return cell;
+            }
+            if (answer != POSSIBLE) continue;
+            for (size_t j = i + 1; j < candidates.size(); j++) {
+                if (phase[candidates[j]] != reference[j]) excluded[j] = 1;
+            }
+        }
+        return -1;
+    }
+
+private:
+    static int literal(int cell, int state) { return cell * 2 + state; }
+    static int cellOf(int lit) { return lit >> 1; }
+
+    bool isFalse(int lit) const { return value[cellOf(lit)] == 1 - (lit & 1); }
+    bool isTrue(int lit) const { return value[cellOf(lit)] == (lit & 1); }
+    int currentLevel() const { return static_cast<int>(trailLimits.size()); }
+
+    void rebuild(const IBoardSolver& board) {
+        gridSize = board.getGridSize();
+        int cellCount = gridSize * gridSize;
+        view.assign(cellCount, UNKNOWN);
+        value.assign(cellCount, UNASSIGNED);
+        level.assign(cellCount, 0);
+        reason.assign(cellCount, NO_REASON);
+        trailPos.assign(cellCount, 0);
+        trail.clear();
+        trailLimits.clear();
+        queueHead = 0;
+        constraints.clear();
+        constraintOf.assign(cellCount, -1);
+        clauses.clear();
+        watches.assign(static_cast<size_t>(cellCount) * 2, {});
+        vars.clear();
+        isVar.assign(cellCount, 0);
+        activity.assign(cellCount, 0.0);
+        activityStep = 1.0;
+        phase.assign(cellCount, 0); // Most cells are safe
+        seen.assign(cellCount, 0);
+        contradiction = false;
+
+        for (int index = 0; index < cellCount; index++) {
+            int state = board.getViewState(index % gridSize, index / gridSize);
+            if (state != UNKNOWN) apply(index, static_cast<std::int8_t>(state));
+        }
+        if (!propagate().empty()) contradiction = true;
+        syncedEpoch = board.getChangeEpoch();
+        syncedLogSize = board.getChangeLog().size();
+        built = true;
+    }
+
+    // New view state for a cell, at level 0
+    void apply(int index, std::int8_t state) {
+        view[index] = state;
+        if (state == UNKNOWN) return;
+        int fact = (state == FLAGGED || state == IBoardSolver::BOMB) ? 1 : 0;
+        if (value[index] == UNASSIGNED) assign(index, fact, NO_REASON);
+        else if (value[index] != fact) contradiction = true;
+        if (state >= 0 && state != IBoardSolver::BOMB) addConstraint(index, state);
+    }
+
+    int getNeighbors(int index, int* neighbors) const {
+        int x = index % gridSize;
+        int y = index / gridSize;
+        int count = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) continue;
+                int nx = x + dx;
+                int ny = y + dy;
+                if (nx < 0 || nx >= gridSize || ny < 0 || ny >= gridSize) continue;
+                neighbors[count++] = ny * gridSize + nx;
+            }
+        }
+        return count;
+    }
+
+    void addConstraint(int number, int need) {
+        Constraint constraint;
+        constraint.need = need;
+        constraint.size = getNeighbors(number, constraint.cells);
+        for (int i = 0; i < constraint.size; i++) {
+            int cell = constraint.cells[i];
+            if (value[cell] == 1) constraint.trueCount++;
+            if (value[cell] == 0) constraint.falseCount++;
+            if (!isVar[cell]) {
+                isVar[cell] = 1;
+                vars.push_back(cell);
+            }
+        }
+        constraintOf[number] = static_cast<int>(constraints.size());
+        constraints.push_back(constraint);
+        std::vector<int> conflict;
+        if (!checkConstraint(constraintOf[number], conflict)) contradiction = true;
+    }
+
+    void assign(int cell, int state, int why) {
+        value[cell] = static_cast<std::int8_t>(state);
+        level[cell] = currentLevel();
+        reason[cell] = why;
+        trailPos[cell] = static_cast<int>(trail.size());
+        trail.push_back(cell);
+        countCell(cell, state, 1);
+    }
+
+    void countCell(int cell, int state, int delta) {
+        int neighbors[8];
+        int count = getNeighbors(cell, neighbors);
+        for (int i = 0; i < count; i++) {
+            int c = constraintOf[neighbors[i]];
+            if (c < 0) continue;
+            if (state == 1) constraints[c].trueCount += delta;
+            else constraints[c].falseCount += delta;
+        }
+    }
+
+    void backtrack(int toLevel) {
+        if (currentLevel() <= toLevel) return;
+        size_t keep = trailLimits[toLevel];
+        while (trail.size() > keep) {
+            int cell = trail.back();
+            trail.pop_back();
+            countCell(cell, value[cell], -1);
+            phase[cell] = value[cell];
+            value[cell] = UNASSIGNED;
+        }
+        trailLimits.resize(toLevel);
+        queueHead = std::min(queueHead, trail.size());
+    }
+
+    // Forces what a constraint's counters allow; false (with the falsified literals) on conflict
+    bool checkConstraint(int c, std::vector<int>& conflict) {
+        Constraint& constraint = constraints[c];
+        int open = constraint.size - constraint.falseCount;
+        if (constraint.trueCount > constraint.need || open < constraint.need) {
+            int bad = constraint.trueCount > constraint.need ? 1 : 0;
+            for (int i = 0; i < constraint.size; i++) {
+                int cell = constraint.cells[i];
+                if (value[cell] == bad) conflict.push_back(literal(cell, 1 - bad));
+            }
+            return false;
+        }
+        int forced = constraint.trueCount == constraint.need ? 0 : (open == constraint.need ? 1 : -1);
+        if (forced < 0) return true;
+        for (int i = 0; i < constraint.size; i++) {
+            int cell = constraint.cells[i];
+            if (value[cell] == UNASSIGNED) assign(cell, forced, -2 - c);
+        }
+        return true;
+    }
+
+    // Unit propagation; returns the falsified literals of a conflict, empty if none
+    std::vector<int> propagate() {
+        std::vector<int> conflict;
+        int neighbors[8];
+        while (queueHead < trail.size()) {
+            int cell = trail[queueHead++];
+            int count = getNeighbors(cell, neighbors);
+            for (int i = 0; i < count; i++) {
+                int c = constraintOf[neighbors[i]];
+                if (c >= 0 && !checkConstraint(c, conflict)) return conflict;
+            }
+
+            int falsified = literal(cell, 1 - value[cell]);
+            std::vector<int>& watching = watches[falsified];
+            size_t kept = 0;
+            for (size_t w = 0; w < watching.size(); w++) {
+                int id = watching[w];
+                std::vector<int>& clause = clauses[id];
+                if (clause[0] == falsified) std::swap(clause[0], clause[1]);
+                if (isTrue(clause[0])) {
+                    watching[kept++] = id;
+                    continue;
+                }
+                // Look for a new literal to watch
+                bool moved = false;
+                for (size_t k = 2; k < clause.size(); k++) {
+                    if (!isFalse(clause[k])) {
+                        std::swap(clause[1], clause[k]);
+                        watches[clause[1]].push_back(id);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) continue;
+                watching[kept++] = id;
+                if (isFalse(clause[0])) {
+                    conflict = clause;
+                    for (w++; w < watching.size(); w++) watching[kept++] = watching[w];
+                    watching.resize(kept);
+                    return conflict;
+                }
+                assign(cellOf(clause[0]), clause[0] & 1, id);
+            }
+            watching.resize(kept);
+        }
+        return conflict;
+    }
+
+    // False literals that implied the cell's value
+    void explain(int cell, std::vector<int>& out) const {
+        out.clear();
+        int why = reason[cell];
+        if (why >= 0) {
+            for (int lit : clauses[why]) {
+                if (cellOf(lit) != cell) out.push_back(lit);
+            }
+            return;
+        }
+        // Constraint reason: the earlier cells already holding the value it counted
+        const Constraint& constraint = constraints[-2 - why];
+        int counted = value[cell] == 0 ? 1 : 0;
+        for (int i = 0; i < constraint.size; i++) {
+            int other = constraint.cells[i];
+            if (other != cell && value[other] == counted && trailPos[other] < trailPos[cell]) {
+                out.push_back(literal(other, 1 - counted));
+            }
+        }
+    }
+
+    // First-UIP conflict analysis; backjumps and asserts the learned clause.
+    // False if the conflict holds at level 0
+    bool learn(const std::vector<int>& conflict) {
+        int conflictLevel = 0;
+        for (int lit : conflict) conflictLevel = std::max(conflictLevel, level[cellOf(lit)]);
+        if (conflictLevel == 0) return false;
+        backtrack(conflictLevel);
+
+        std::vector<int> learned(1, 0);
+        std::vector<int> antecedent = conflict;
+        int pending = 0;
+        int index = static_cast<int>(trail.size()) - 1;
+        int uip = -1;
+        while (true) {
+            for (int lit : antecedent) {
+                int cell = cellOf(lit);
+                if (seen[cell] || level[cell] == 0) continue;
+                seen[cell] = 1;
+                bump(cell);
+                if (level[cell] == currentLevel()) pending++;
+                else learned.push_back(lit);
+            }
+            while (!seen[trail[index]]) index--;
+            uip = trail[index--];
+            seen[uip] = 0;
+            if (--pending == 0) break;
+            explain(uip, antecedent);
+        }
+        learned[0] = literal(uip, 1 - value[uip]);
+
+        int jump = 0;
+        for (size_t i = 1; i < learned.size(); i++) {
+            seen[cellOf(learned[i])] = 0;
+            if (level[cellOf(learned[i])] > jump) {
+                jump = level[cellOf(learned[i])];
+                std::swap(learned[1], learned[i]);
+            }
+        }
+        activityStep *= 1.05;
+
+        backtrack(jump);
+        if (learned.size() == 1) {
+            assign(uip, learned[0] & 1, NO_REASON);
+            return true;
+        }
+        if (clauses.size() >= MAX_LEARNED && jump == 0) reduceLearned();
+        int id = static_cast<int>(clauses.size());
+        clauses.push_back(learned);
+        watches[learned[0]].push_back(id);
+        watches[learned[1]].push_back(id);
+        assign(uip, learned[0] & 1, id);
+        return true;
+    }
+
+    void bump(int cell) {
+        activity[cell] += activityStep;
+        if (activity[cell] > 1e100) {
+            for (int v : vars) activity[v] *= 1e-100;
+            activityStep *= 1e-100;
+        }
+    }
+
+    int pickBranch() const {
+        int best = -1;
+        for (int v : vars) {
+            if (value[v] == UNASSIGNED && (best < 0 || activity[v] > activity[best])) best = v;
+        }
+        return best;
+    }
+
+    // Keeps the shorter half of the learned clauses; only called at level 0,
+    // where no assignment still points at a clause as its reason
+    void reduceLearned() {
+        for (int v : trail) {
+            if (reason[v] >= 0) reason[v] = NO_REASON;
+        }
+        std::stable_sort(clauses.begin(), clauses.end(), [](const std::vector<int>& a, const std::vector<int>& b) {
+            return a.size() < b.size();
+        });
+        clauses.resize(clauses.size() / 2);
+        for (auto& list : watches) list.clear();
+        for (size_t id = 0; id < clauses.size(); id++) {
+            watches[clauses[id][0]].push_back(static_cast<int>(id));
+            watches[clauses[id][1]].push_back(static_cast<int>(id));
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include "BoardSnapshot.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * Exact play for the last few unknown cells.
+ *
+ * Every placement of the remaining mines over the unknowns that fits the numbers is
+ * enumerated as a bitmask (the global mine count prunes by popcount as cells are
+ * assigned). The value of a set of placements is the probability of clearing the
+ * board from there with best play: 1 once they agree on every cell, otherwise the
+ * best guess's share of placements where it is safe, split by the number it would
+ * show and recursed into. Sets are memoized by hash. Openings that cascade are not
+ * modelled, so the value is a lower bound on the true win chance.
+ * Refuses (solve() == false) when there are too many placements or too much work.
+ */
+class endgameSolver {
+public:
+    static const int MAX_UNKNOWNS = 32;
+    static const int MAX_LAYOUTS = 1024;
+    static const long MAX_WORK = 1 << 17; // Layouts examined across all nodes, keeps a solve well under a millisecond
+
+private:
+    struct Constraint {
+        int need;
+        int assigned = 0;
+        int open = 0;
+    };
+
+    std::vector<int> cells;                // Bit i of a layout is cells[i]
+    std::vector<std::uint32_t> around;     // Per bit: neighbor bits among the unknowns
+    std::vector<std::uint32_t> layouts;
+    std::unordered_map<std::uint64_t, double> memo;
+    int nodes = 0;
+    long work = 0;
+    bool aborted = false;
+    int bestCell = -1;
+    double winProbability = 0.0;
+
+    // Enumeration state
+    std::vector<Constraint> constraints;
+    std::vector<std::vector<int>> cellConstraints;
+    int minesLeft = 0;
+
+public:
+    // True if the position was solved; getBestCell() is then the guess with the best win chance
+    bool solve(const BoardSnapshot& snapshot) {
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        if (snapshot.getUnknownCount() > MAX_UNKNOWNS) return false;
+
+        cells.clear();
+        std::vector<int> bitOf(cellCount, -1);
+        for (int index = 0; index < cellCount; index++) {
+            if (!snapshot.isUnknown(index)) continue;
+            bitOf[index] = static_cast<int>(cells.size());
+            cells.push_back(index);
+        }
+        int size = static_cast<int>(cells.size());
+        if (size == 0) return false;
+
+        int neighbors[8];
+        around.assign(size, 0);
+        for (int bit = 0; bit < size; bit++) {
+            int count = snapshot.getNeighbors(cells[bit], neighbors);
+            for (int i = 0; i < count; i++) {
+                if (bitOf[neighbors[i]] >= 0) around[bit] |= std::uint32_t(1) << bitOf[neighbors[i]];
+            }
+        }
+
+        // Revealed numbers next to unknowns, with flags taken as mines
+        constraints.clear();
+        cellConstraints.assign(size, {});
+        for (int index = 0; index < cellCount; index++) {
+            int value = snapshot.get(index);
+            if (value < 0 || value > 8) continue;
+            Constraint constraint;
+            constraint.need = value;
+            int count = snapshot.getNeighbors(index, neighbors);
+            for (int i = 0; i < count; i++) {
+                int neighbor = snapshot.get(neighbors[i]);
+                if (neighbor == BoardSnapshot::FLAGGED) constraint.need--;
+                if (bitOf[neighbors[i]] < 0) continue;
+                cellConstraints[bitOf[neighbors[i]]].push_back(static_cast<int>(constraints.size()));
+                constraint.open++;
+            }
+            if (constraint.open == 0) continue;
+            if (constraint.need < 0 || constraint.need > constraint.open) return false;
+            constraints.push_back(constraint);
+        }
+
+        minesLeft = snapshot.getTotalMines() - snapshot.getFlagCount();
+        if (minesLeft < 0 || minesLeft > size) return false;
+        layouts.clear();
+        aborted = false;
+        enumerate(0, 0, 0);
+        if (aborted || layouts.empty()) return false;
+
+        memo.clear();
+        nodes = 0;
+        work = 0;
+        std::vector<int> all(layouts.size());
+        for (size_t i = 0; i < all.size(); i++) all[i] = static_cast<int>(i);
+        int best = -1;
+        winProbability = value(all, &best);
+        if (aborted || best < 0) return false;
+        bestCell = cells[best];
+        return true;
+    }
+
+    int getBestCell() const { return bestCell; }
+    double getWinProbability() const { return winProbability; }
+    int getLayoutCount() const { return static_cast<int>(layouts.size()); }
+    int getNodes() const { return nodes; }
+
+private:
+    void enumerate(int bit, std::uint32_t mask, int mines) {
+        if (aborted) return;
+        int size = static_cast<int>(cells.size());
+        if (bit == size) {
+            if (static_cast<int>(layouts.size()) >= MAX_LAYOUTS) {
+                aborted = true;
+                return;
+            }
+            layouts.push_back(mask);
+            return;
+        }
+        for (int mine = 0; mine <= 1; mine++) {
+            // Popcount pruning: the mines left must still fit in the cells left
+            int placed = mines + mine;
+            if (placed > minesLeft || placed + (size - bit - 1) < minesLeft) continue;
+            bool feasible = true;
+            for (int c : cellConstraints[bit]) {
+                Constraint& constraint = constraints[c];
+                constraint.open--;
+                constraint.assigned += mine;
+                if (constraint.assigned > constraint.need || constraint.assigned + constraint.open < constraint.need) feasible = false;
+            }
+            if (feasible) enumerate(bit + 1, mine ? mask | (std::uint32_t(1) << bit) : mask, placed);
+            for (int c : cellConstraints[bit]) {
+                constraints[c].open++;
+                constraints[c].assigned -= mine;
+            }
+        }
+    }
+
+    std::uint64_t hashOf(const std::vector<int>& set) const {
+        std::uint64_t hash = 0x9E3779B97F4A7C15ULL;
+        for (int layout : set) {
+            hash ^= static_cast<std::uint64_t>(layout) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+
+    // Win probability from a set of still-possible layouts (indices, ascending)
+    double value(const std::vector<int>& set, int* bestBit = nullptr) {
+        std::uint32_t always = ~std::uint32_t(0), ever = 0;
+        for (int layout : set) {
+            always &= layouts[layout];
+            ever |= layouts[layout];
+        }
+        int size = static_cast<int>(cells.size());
+        std::uint32_t undecided = always ^ ever;
+        if (undecided == 0 && !bestBit) return 1.0;
+
+        std::uint64_t key = hashOf(set);
+        if (!bestBit) {
+            auto found = memo.find(key);
+            if (found != memo.end()) return found->second;
+        }
+        nodes++;
+        work += static_cast<long>(set.size()) * size;
+
+        // Candidates: every cell that is safe somewhere, most often safe first, so the
+        // bound (a guess can't beat its own survival odds) cuts the rest off early
+        std::vector<std::pair<int, int>> candidates;
+        for (int bit = 0; bit < size; bit++) {
+            if (always >> bit & 1) continue;
+            int safe = 0;
+            for (int layout : set) safe += !(layouts[layout] >> bit & 1);
+            candidates.push_back({-safe, bit});
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        double best = -1.0;
+        std::vector<int> groups[9];
+        for (const auto& [negativeSafe, bit] : candidates) {
+            double bound = static_cast<double>(-negativeSafe) / set.size();
+            if (bound <= best) break;
+            work += static_cast<long>(set.size());
+            if (work > MAX_WORK) {
+                aborted = true;
+                return 0.0;
+            }
+            for (auto& group : groups) group.clear();
+            for (int layout : set) {
+                if (layouts[layout] >> bit & 1) continue;
+                groups[__builtin_popcount(layouts[layout] & around[bit])].push_back(layout);
+            }
+            // A safe cell that tells us nothing new can't change the outcome
+            if (-negativeSafe == static_cast<int>(set.size()) && undecided != 0) {
+                bool splits = false;
+                for (const auto& group : groups) splits |= !group.empty() && group.size() != set.size();
+                if (!splits) continue;
+            }
+            // Groups still to score can add at most their size, so stop once that can't beat the best
+            double total = 0.0;
+            int unscored = -negativeSafe;
+            for (const auto& group : groups) {
+                if (group.empty()) continue;
+                if ((total + unscored) / set.size() <= best) break;
+                unscored -= static_cast<int>(group.size());
+                total += value(group) * group.size();
+                if (aborted) return 0.0;
+            }
+            total /= set.size();
+            if (total > best) {
+                best = total;
+                if (bestBit) *bestBit = bit;
+            }
+        }
+        if (best < 0.0) best = 0.0;
+        memo[key] = best;
+        return best;
+    }
+};
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef FRONTIER_ANALYSIS_H
+#define FRONTIER_ANALYSIS_H
+
+#include "BoardSnapshot.h"
+#include "transferMatrix.cpp"
+#include "componentCache.cpp"
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * Exact mine probabilities for a player view.
+ * The consistent mine assignments of each frontier component are enumerated by
+ * backtracking, or counted with a transfer-matrix sweep when the component is
+ * long and thin, then the components and the unconstrained "outside" cells are
+ * tied together through the global mine count. Flags are treated as mines.
+ * Solved components are memoized by shape in the thread's componentCache.
+ * Gives up (isExact() == false) when a component is too big or the deadline passes.
+ */
+class frontierAnalysis {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const int MAX_COMPONENT_CELLS = 48;
+    static const int MAX_SOLUTIONS = 200000;
+    static const int TRANSFER_MIN_CELLS = 16; // Smaller components are cheaper to enumerate
+    static const int CACHE_MIN_CELLS = 10;    // Smaller ones solve faster than their signature is built
+
+    struct Component {
+        std::vector<int> cells;               // Bit i of a solution is cells[i]
+        std::vector<std::uint64_t> solutions;
+        std::vector<int> solutionMines;
+        std::vector<double> weightByMines;    // Relative weight of one solution with k mines
+
+        // Set instead of the solution list when the component was counted by transfer matrix
+        bool counted = false;
+        transferMatrix::Counts counts;
+    };
+
+private:
+    struct Constraint {
+        int need;
+        int assigned = 0;
+        int open = 0;
+    };
+
+    std::vector<Component> components;
+    std::vector<int> componentOf;      // Per cell, -1 if not on the frontier
+    std::vector<int> bitOf;            // Per cell, bit within its component
+    std::vector<double> probability;   // Per cell, -1 for revealed cells
+    std::vector<int> safeCells;
+    std::vector<int> mineCells;
+    int outsideCells = 0;
+    double outsideProbability = 0.0;
+    bool exact = false;
+
+    // Backtracking state
+    std::vector<Constraint> constraints;
+    std::vector<std::vector<int>> cellConstraints;
+    Component* current = nullptr;
+    Clock::time_point deadline;
+    bool aborted = false;
+    int steps = 0;
+
+public:
+    // Returns false if the position was too hard to solve exactly in time
+    bool analyze(const BoardSnapshot& snapshot, Clock::time_point until) {
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        components.clear();
+        componentOf.assign(cellCount, -1);
+        bitOf.assign(cellCount, -1);
+        probability.assign(cellCount, -1.0);
+        safeCells.clear();
+        mineCells.clear();
+        deadline = until;
+        aborted = false;
+        exact = false;
+
+        std::vector<BoardSnapshot::FrontierComponent> frontier = snapshot.getFrontierComponents();
+        int frontierCells = 0;
+        for (const auto& part : frontier) {
+            Component component;
+            component.cells = part.unknowns;
+            if (!solve(snapshot, part, component)) return false;
+            for (size_t i = 0; i < component.cells.size(); i++) {
+                componentOf[component.cells[i]] = static_cast<int>(components.size());
+                bitOf[component.cells[i]] = static_cast<int>(i);
+            }
+            frontierCells += static_cast<int>(component.cells.size());
+            components.push_back(std::move(component));
+        }
+
+        outsideCells = snapshot.getUnknownCount() - frontierCells;
+        int minesLeft = snapshot.getTotalMines() - snapshot.getFlagCount();
+        if (!combine(minesLeft)) return false;
+
+        // Per-cell marginals
+        for (const auto& component : components) {
+            if (component.counted) {
+                double componentWeight = 0.0;
+                for (size_t k = 0; k < component.counts.byMines.size(); k++) {
+                    componentWeight += component.counts.byMines[k] * component.weightByMines[k];
+                }
+                for (size_t i = 0; i < component.cells.size(); i++) {
+                    const std::vector<double>& byMines = component.counts.cellByMines[i];
+                    double cellWeight = 0.0;
+                    for (size_t k = 0; k < byMines.size() && k < component.weightByMines.size(); k++) {
+                        cellWeight += byMines[k] * component.weightByMines[k];
+                    }
+                    probability[component.cells[i]] = cellWeight / componentWeight;
+                }
+                continue;
+            }
+            std::vector<double> cellWeight(component.cells.size(), 0.0);
+            double componentWeight = 0.0;
+            for (size_t s = 0; s < component.solutions.size(); s++) {
+                double weight = component.weightByMines[component.solutionMines[s]];
+                componentWeight += weight;
+                for (std::uint64_t bits = component.solutions[s]; bits; bits &= bits - 1) {
+                    cellWeight[__builtin_ctzll(bits)] += weight;
+                }
+            }
+            for (size_t i = 0; i < component.cells.size(); i++) {
+                probability[component.cells[i]] = cellWeight[i] / componentWeight;
+            }
+        }
+        for (int index = 0; index < cellCount; index++) {
+            if (!snapshot.isUnknown(index)) continue;
+            if (componentOf[index] < 0) probability[index] = outsideProbability;
+            if (probability[index] <= 0.0) safeCells.push_back(index);
+            else if (probability[index] >= 1.0) mineCells.push_back(index);
+        }
+        exact = true;
+        return true;
+    }
+
+    bool isExact() const { return exact; }
+    double getMineProbability(int index) const { return probability[index]; }
+    const std::vector<int>& getSafeCells() const { return safeCells; }
+    const std::vector<int>& getMineCells() const { return mineCells; }
+    const std::vector<Component>& getComponents() const { return components; }
+    int getOutsideCells() const { return outsideCells; }
+
+    // Probability of each number 0-8 showing at `index` if revealed; the entries sum to P(safe).
+    // An enumerated component is handled jointly, other neighbors by their marginals.
+    double getOutcomes(const BoardSnapshot& snapshot, int index, double outcomes[9]) const {
+        std::fill(outcomes, outcomes + 9, 0.0);
+        int neighbors[8];
+        int count = snapshot.getNeighbors(index, neighbors);
+        int own = componentOf[index];
+        if (own >= 0 && components[own].counted) own = -1;
+
+        int knownMines = 0;
+        std::uint64_t ownMask = 0;
+        std::vector<double> others(1, 1.0); // Distribution of mines among the remaining neighbors
+        for (int i = 0; i < count; i++) {
+            int neighbor = neighbors[i];
+            int value = snapshot.get(neighbor);
+            if (value == BoardSnapshot::FLAGGED) knownMines++;
+            if (value != BoardSnapshot::UNKNOWN) continue;
+            if (own >= 0 && componentOf[neighbor] == own) {
+                ownMask |= std::uint64_t(1) << bitOf[neighbor];
+                continue;
+            }
+            double p = probability[neighbor];
+            others.push_back(0.0);
+            for (size_t m = others.size() - 1; m > 0; m--) {
+                others[m] = others[m] * (1.0 - p) + others[m - 1] * p;
+            }
+            others[0] *= 1.0 - p;
+        }
+
+        if (own < 0) {
+            double safe = 1.0 - probability[index];
+            for (size_t m = 0; m < others.size() && knownMines + m <= 8; m++) {
+                outcomes[knownMines + m] += safe * others[m];
+            }
+            return safe;
+        }
+
+        const Component& component = components[own];
+        std::uint64_t selfBit = std::uint64_t(1) << bitOf[index];
+        double totalWeight = 0.0;
+        for (size_t s = 0; s < component.solutions.size(); s++) {
+            totalWeight += component.weightByMines[component.solutionMines[s]];
+        }
+        double safe = 0.0;
+        for (size_t s = 0; s < component.solutions.size(); s++) {
+            if (component.solutions[s] & selfBit) continue;
+            double weight = component.weightByMines[component.solutionMines[s]] / totalWeight;
+            int local = __builtin_popcountll(component.solutions[s] & ownMask);
+            safe += weight;
+            for (size_t m = 0; m < others.size() && knownMines + local + m <= 8; m++) {
+                outcomes[knownMines + local + m] += weight * others[m];
+            }
+        }
+        return safe;
+    }
+
+private:
+    static double logChoose(int n, int k) {
+        if (k < 0 || k > n) return -INFINITY;
+        return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+    }
+
+    // Fills in one component's solutions or counts; false if it has none or is too hard
+    bool solve(const BoardSnapshot& snapshot, const BoardSnapshot::FrontierComponent& part, Component& component) {
+        int size = static_cast<int>(part.unknowns.size());
+        componentCache::Signature signature;
+        componentCache& cache = componentCache::local();
+        if (size >= CACHE_MIN_CELLS) {
+            signature = componentCache::signature(snapshot, part);
+            if (const componentCache::Entry* entry = cache.find(signature.key)) {
+                fromCanonical(*entry, signature.order, component);
+                return true;
+            }
+        }
+
+        if (size >= TRANSFER_MIN_CELLS && transferMatrix::count(snapshot, part, component.counts)) {
+            component.counted = true;
+            double total = 0.0;
+            for (double count : component.counts.byMines) total += count;
+            if (total <= 0.0) return false; // Contradictory view (e.g. a wrong flag)
+        } else {
+            if (size > MAX_COMPONENT_CELLS) return false;
+            if (!enumerate(snapshot, part, component)) return false;
+            if (component.solutions.empty()) return false;
+        }
+
+        if (size >= CACHE_MIN_CELLS) cache.insert(signature.key, toCanonical(component, signature.order));
+        return true;
+    }
+
+    static componentCache::Entry toCanonical(const Component& component, const std::vector<int>& order) {
+        componentCache::Entry entry;
+        entry.counted = component.counted;
+        if (component.counted) {
+            entry.counts.byMines = component.counts.byMines;
+            entry.counts.cellByMines.resize(order.size());
+            for (size_t i = 0; i < order.size(); i++) entry.counts.cellByMines[i] = component.counts.cellByMines[order[i]];
+            return entry;
+        }
+        std::vector<int> canonicalBit(order.size());
+        for (size_t i = 0; i < order.size(); i++) canonicalBit[order[i]] = static_cast<int>(i);
+        entry.solutionMines = component.solutionMines;
+        entry.solutions.reserve(component.solutions.size());
+        for (std::uint64_t solution : component.solutions) {
+            std::uint64_t mapped = 0;
+            for (std::uint64_t bits = solution; bits; bits &= bits - 1) mapped |= std::uint64_t(1) << canonicalBit[__builtin_ctzll(bits)];
+            entry.solutions.push_back(mapped);
+        }
+        return entry;
+    }
+
+    static void fromCanonical(const componentCache::Entry& entry, const std::vector<int>& order, Component& component) {
+        component.counted = entry.counted;
+        if (entry.counted) {
+            component.counts.byMines = entry.counts.byMines;
+            component.counts.cellByMines.resize(order.size());
+            for (size_t i = 0; i < order.size(); i++) component.counts.cellByMines[order[i]] = entry.counts.cellByMines[i];
+            return;
+        }
+        component.solutionMines = entry.solutionMines;
+        component.solutions.reserve(entry.solutions.size());
+        for (std::uint64_t solution : entry.solutions) {
+            std::uint64_t mapped = 0;
+            for (std::uint64_t bits = solution; bits; bits &= bits - 1) mapped |= std::uint64_t(1) << order[__builtin_ctzll(bits)];
+            component.solutions.push_back(mapped);
+        }
+    }
+
+    bool enumerate(const BoardSnapshot& snapshot, const BoardSnapshot::FrontierComponent& part, Component& component) {
+        int size = static_cast<int>(component.cells.size());
+        constraints.clear();
+        cellConstraints.assign(size, {});
+
+        int neighbors[8];
+        for (int number : part.numbers) {
+            Constraint constraint;
+            constraint.need = snapshot.get(number);
+            int count = snapshot.getNeighbors(number, neighbors);
+            for (int i = 0; i < count; i++) {
+                int value = snapshot.get(neighbors[i]);
+                if (value == BoardSnapshot::FLAGGED) constraint.need--;
+                if (value != BoardSnapshot::UNKNOWN) continue;
+                int bit = static_cast<int>(std::lower_bound(component.cells.begin(), component.cells.end(), neighbors[i]) - component.cells.begin());
+                cellConstraints[bit].push_back(static_cast<int>(constraints.size()));
+                constraint.open++;
+            }
+            if (constraint.need < 0 || constraint.need > constraint.open) return true; // No solutions
+            constraints.push_back(constraint);
+        }
+
+        current = &component;
+        steps = 0;
+        search(0, 0, 0);
+        current = nullptr;
+        return !aborted;
+    }
+
+    void search(int bit, std::uint64_t mask, int mines) {
+        if (aborted) return;
+        if ((++steps & 1023) == 0 && Clock::now() > deadline) {
+            aborted = true;
+            return;
+        }
+        if (bit == static_cast<int>(current->cells.size())) {
+            if (static_cast<int>(current->solutions.size()) >= MAX_SOLUTIONS) {
+                aborted = true;
+                return;
+            }
+            current->solutions.push_back(mask);
+            current->solutionMines.push_back(mines);
+            return;
+        }
+
+        // Try safe, then mine, keeping every touched constraint satisfiable
+        for (int mine = 0; mine <= 1; mine++) {
+            bool feasible = true;
+            for (int c : cellConstraints[bit]) {
+                Constraint& constraint = constraints[c];
+                constraint.open--;
+                constraint.assigned += mine;
+                if (constraint.assigned > constraint.need || constraint.assigned + constraint.open < constraint.need) feasible = false;
+            }
+            if (feasible) search(bit + 1, mine ? mask | (std::uint64_t(1) << bit) : mask, mines + mine);
+            for (int c : cellConstraints[bit]) {
+                constraints[c].open++;
+                constraints[c].assigned -= mine;
+            }
+        }
+    }
+
+    // Weighs each component's solutions by how many ways the other components and
+    // the outside cells can hold the remaining mines
+    bool combine(int minesLeft) {
+        std::vector<std::vector<double>> counts(components.size());
+        for (size_t j = 0; j < components.size(); j++) {
+            if (components[j].counted) {
+                counts[j] = components[j].counts.byMines;
+                continue;
+            }
+            for (int mines : components[j].solutionMines) {
+                if (static_cast<int>(counts[j].size()) <= mines) counts[j].resize(mines + 1, 0.0);
+                counts[j][mines] += 1.0;
+            }
+        }
+
+        auto convolve = [](const std::vector<double>& a, const std::vector<double>& b) {
+            std::vector<double> result(a.size() + b.size() - 1, 0.0);
+            for (size_t i = 0; i < a.size(); i++) {
+                if (a[i] == 0.0) continue;
+                for (size_t k = 0; k < b.size(); k++) result[i + k] += a[i] * b[k];
+            }
+            return result;
+        };
+
+        // Outside weight for t frontier mines: C(outside, minesLeft - t), scaled to stay in range
+        int maxFrontier = 0;
+        for (const auto& count : counts) maxFrontier += static_cast<int>(count.size()) - 1;
+        std::vector<double> logOutside(maxFrontier + 1);
+        double logScale = -INFINITY;
+        for (int t = 0; t <= maxFrontier; t++) {
+            logOutside[t] = logChoose(outsideCells, minesLeft - t);
+            logScale = std::max(logScale, logOutside[t]);
+        }
+        if (logScale == -INFINITY) return false; // Mine count can't be met
+        std::vector<double> outsideWeight(maxFrontier + 1);
+        for (int t = 0; t <= maxFrontier; t++) outsideWeight[t] = std::exp(logOutside[t] - logScale);
+
+        // Prefix / suffix products give each component the distribution of all the others
+        size_t n = components.size();
+        std::vector<std::vector<double>> prefix(n + 1, std::vector<double>(1, 1.0));
+        std::vector<std::vector<double>> suffix(n + 1, std::vector<double>(1, 1.0));
+        for (size_t j = 0; j < n; j++) prefix[j + 1] = convolve(prefix[j], counts[j]);
+        for (size_t j = n; j > 0; j--) suffix[j - 1] = convolve(suffix[j], counts[j - 1]);
+
+        for (size_t j = 0; j < n; j++) {
+            std::vector<double> others = convolve(prefix[j], suffix[j + 1]);
+            std::vector<double>& weights = components[j].weightByMines;
+            weights.assign(counts[j].size(), 0.0);
+            for (size_t k = 0; k < counts[j].size(); k++) {
+                for (size_t m = 0; m < others.size() && k + m <= static_cast<size_t>(maxFrontier); m++) {
+                    weights[k] += others[m] * outsideWeight[k + m];
+                }
+            }
+        }
+
+        // Outside cells share the expected leftover mines evenly
+        const std::vector<double>& all = prefix[n];
+        double total = 0.0;
+        double expectedOutside = 0.0;
+        for (size_t t = 0; t < all.size(); t++) {
+            double weight = all[t] * outsideWeight[t];
+            total += weight;
+            expectedOutside += weight * (minesLeft - static_cast<int>(t));
+        }
+        if (total <= 0.0) return false;
+        outsideProbability = outsideCells > 0 ? expectedOutside / total / outsideCells : 0.0;
+        return true;
+    }
+};
+
+#endif
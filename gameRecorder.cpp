@@ -0,0 +1,98 @@
+#ifndef GAME_RECORDER_H
+#define GAME_RECORDER_H
+
+#include "IBoardSolver.h"
+#include "GameStats.h"
+#include "guessSearch.cpp"
+#include "optimalityOracle.cpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/**
+ * The metrics bookkeeping both solvers share: times and counts the moves of the
+ * current game, credits deductions to the rule that queued them, judges guesses
+ * with the oracle when asked to and folds finished games into the solver's stats.
+ */
+class gameRecorder {
+private:
+    IBoardSolver& board;
+    GameMetrics current;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    unsigned int epoch; // Board epoch the metrics belong to
+    GameStats stats;
+
+    // Judges guesses against every certain move; off unless a batch run asks for it
+    optimalityOracle oracle;
+    bool oracleEnabled = false;
+
+public:
+    explicit gameRecorder(IBoardSolver& b) : board(b), epoch(b.getChangeEpoch()), stats(b.getGridSize()) {}
+
+    void start() {
+        epoch = board.getChangeEpoch();
+        current = GameMetrics();
+        started = std::chrono::steady_clock::now();
+    }
+
+    // Before each click: game time runs from the new board to the last click. A board
+    // reset behind our back (R in the GUI) starts the metrics over
+    void noteMove() {
+        if (board.getChangeEpoch() != epoch) start();
+        current.moves++;
+        current.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    // Before a guess: did it risk a mine while the oracle could prove some cell safe?
+    void noteGuess(int cellIndex) {
+        current.guesses++;
+        int gridSize = board.getGridSize();
+        // A click on a flagged or revealed cell risks nothing
+        if (!oracleEnabled || board.getViewState(cellIndex % gridSize, cellIndex / gridSize) != -1) return;
+        if (!oracle.analyze(board)) current.uncheckedGuesses++;
+        const std::vector<int>& safe = oracle.getSafeCells();
+        if (!safe.empty() && std::find(safe.begin(), safe.end(), cellIndex) == safe.end()) current.missedSafeMoves++;
+    }
+
+    void credit(GameMetrics::Rule rule, int moves = 1) { current.deductions[rule] += moves; }
+
+    // Runs a rule and credits it with every move it queued
+    template <typename Queue, typename Rule>
+    void deduce(GameMetrics::Rule rule, const Queue& reveal, const Queue& flag, Rule apply) {
+        size_t queued = reveal.size() + flag.size();
+        apply();
+        credit(rule, static_cast<int>(reveal.size() + flag.size() - queued));
+    }
+
+    // Runs the guess search and logs its pick under tag; a pick the search proved safe
+    // counts as a deduction, anything else as a guess. False if the position was too big
+    bool searchGuess(guessSearch& guesser, const char* tag, std::pair<int, int>& move, bool& isGuess) {
+        if (!guesser.chooseGuess(board, move)) return false;
+        if (guesser.lastGuessWasEndgame()) {
+            std::cout << tag << " Endgame guess (" << move.first << ", " << move.second << ") win chance "
+                      << guesser.getLastWinEstimate() << std::endl;
+        } else {
+            std::cout << tag << " Searched guess (" << move.first << ", " << move.second << ") survival estimate "
+                      << guesser.getLastWinEstimate() << " (" << guesser.getNodes() << " nodes)" << std::endl;
+        }
+        isGuess = guesser.getLastWinEstimate() < 1.0;
+        if (!isGuess) credit(GameMetrics::GUESS_SEARCH);
+        return true;
+    }
+
+    // Records the finished game in the stats
+    void finish() {
+        current.won = board.getGameState() == IBoardSolver::WON;
+        current.threeBV = board.getThreeBV();
+        stats.record(current);
+    }
+
+    // Counts guesses made while a provably safe cell existed (costs an exact analysis per guess)
+    void setOracle(bool enabled) { oracleEnabled = enabled; }
+
+    const GameStats& getStats() const { return stats; }
+};
+
+#endif
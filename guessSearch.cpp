@@ -0,0 +1,273 @@
+#ifndef GUESS_SEARCH_H
+#define GUESS_SEARCH_H
+
+#include "IBoardSolver.h"
+#include "BoardSnapshot.h"
+#include "frontierAnalysis.cpp"
+#include "probabilityEngine.cpp"
+#include "endgameSolver.cpp"
+#include "workerPool.cpp"
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * Bounded-depth expectimax over guess outcomes.
+ * A position is worth 1 once a provably safe cell exists (progress is free);
+ * otherwise it is worth the best guess's P(safe) times the expected worth of
+ * the numbers that guess can reveal. Positions are memoized by Zobrist hash.
+ * Runs under a per-move time budget. A candidate whose search ran out of time
+ * is only an upper bound, so it is never ranked against fully searched ones;
+ * if no candidate finished, all are ranked on plain P(safe). When the root is
+ * too big to enumerate, sampled probabilities pick the safest cell instead.
+ * With few unknowns left, the endgame solver plays the rest out exactly.
+ * Root candidates are scored on parallel workers (threads kept for the
+ * searcher's lifetime), each with its own snapshot and table, and ranked by
+ * survival times a small bonus for the cells each outcome is expected to
+ * force, so an informative guess beats a dead one.
+ */
+class guessSearch {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const int DEFAULT_DEPTH = 2;
+    static constexpr double DEFAULT_BUDGET_MS = 20.0;
+    static const int CANDIDATES = 8;            // Guesses searched per node, safest first
+    static const size_t MAX_TABLE_ENTRIES = 1 << 18;
+    static constexpr double INFO_WEIGHT = 0.01; // Root bonus per expected newly forced cell
+
+private:
+    struct TableEntry {
+        int depth;
+        double value;
+        int forced; // Safe cells plus newly certain mines in the position
+    };
+
+    // Search state for one thread; root candidates are spread over these
+    struct Worker {
+        std::unordered_map<std::uint64_t, TableEntry> table;
+        Clock::time_point deadline;
+        int rootMines = 0;
+        int nodes = 0;
+        int tableHits = 0;
+        bool timedOut = false; // Some node of the current candidate was cut short
+
+        double scoreGuess(BoardSnapshot& snapshot, const frontierAnalysis& analysis, int cell, int remainingDepth, double* progress = nullptr) {
+            double outcomes[9];
+            double safe = analysis.getOutcomes(snapshot, cell, outcomes);
+            if (progress) *progress = 0.0;
+            if (remainingDepth <= 0 || safe <= 0.0) return safe;
+
+            double value = 0.0;
+            double forcedTotal = 0.0;
+            for (int number = 0; number <= 8; number++) {
+                if (outcomes[number] <= 0.0) continue;
+                size_t mark = snapshot.mark();
+                snapshot.assumeValue(cell, number);
+                int forced = 0;
+                value += outcomes[number] * evaluate(snapshot, remainingDepth, &forced);
+                forcedTotal += outcomes[number] * forced;
+                snapshot.rollback(mark);
+            }
+            if (progress) *progress = forcedTotal / safe;
+            return value;
+        }
+
+        // Worth of the position with the player to move
+        double evaluate(BoardSnapshot& snapshot, int remainingDepth, int* forced = nullptr) {
+            nodes++;
+            std::uint64_t key = snapshot.getHash();
+            auto found = table.find(key);
+            if (found != table.end() && found->second.depth >= remainingDepth) {
+                tableHits++;
+                if (forced) *forced = found->second.forced;
+                return found->second.value;
+            }
+
+            frontierAnalysis analysis;
+            double value;
+            if (forced) *forced = 0;
+            if (!analysis.analyze(snapshot, deadline)) {
+                // Out of time: the caller's value becomes a bound and is discarded.
+                // Otherwise the outcome was contradictory and contributes nothing
+                if (Clock::now() > deadline) timedOut = true;
+                return 0.0;
+            }
+            int newlyForced = static_cast<int>(analysis.getSafeCells().size()) +
+                              std::max(0, static_cast<int>(analysis.getMineCells().size()) - rootMines);
+            if (forced) *forced = newlyForced;
+            if (!analysis.getSafeCells().empty() || snapshot.getUnknownCount() == static_cast<int>(analysis.getMineCells().size())) {
+                value = 1.0;
+            } else {
+                std::vector<int> candidates = pickCandidates(snapshot, analysis);
+                value = 0.0;
+                for (int cell : candidates) {
+                    bool outOfTime = Clock::now() > deadline;
+                    timedOut |= outOfTime && remainingDepth > 1;
+                    value = std::max(value, scoreGuess(snapshot, analysis, cell, outOfTime ? 0 : remainingDepth - 1));
+                }
+            }
+
+            if (Clock::now() <= deadline) table[key] = {remainingDepth, value, newlyForced};
+            return value;
+        }
+    };
+
+    // One root candidate's result
+    struct Scored {
+        double value = -1.0;
+        double progress = 0.0;
+        bool done = false;
+        bool complete = false; // Searched to full depth before the deadline
+        double safe = 0.0;     // Static P(safe), the fallback ranking
+    };
+
+    int depth = DEFAULT_DEPTH;
+    double budgetMs = DEFAULT_BUDGET_MS;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Worker> workers;
+    std::unique_ptr<workerPool> pool; // Started on the first parallel guess
+    probabilityEngine rootEngine;
+    endgameSolver endgame;
+    int nodes = 0;
+    int tableHits = 0;
+    double lastWinEstimate = 0.0;
+    bool lastWasEndgame = false;
+
+public:
+    void setDepth(int newDepth) { depth = std::max(1, newDepth); }
+    void setBudget(double milliseconds) { budgetMs = milliseconds; }
+    double getBudget() const { return budgetMs; }
+    bool isEnabled() const { return budgetMs > 0.0; }
+    void clear() { workers.clear(); }
+
+    // Threads for sampling and for scoring root candidates
+    void setThreads(int count) {
+        threads = std::max(1, count);
+        rootEngine.getSampler().setThreads(threads);
+        if (pool && pool->getThreads() != threads) pool.reset();
+    }
+
+    int getNodes() const { return nodes; }
+    int getTableHits() const { return tableHits; }
+    double getLastWinEstimate() const { return lastWinEstimate; }
+    bool lastGuessWasEndgame() const { return lastWasEndgame; } // Estimate is then the exact win chance
+
+    // Picks the guess with the best searched survival odds, weighted by how much it is
+    // expected to force; false if the position can't be analysed exactly or sampled in
+    // time (caller keeps its own heuristic)
+    bool chooseGuess(const IBoardSolver& board, std::pair<int, int>& guess) {
+        if (!isEnabled()) return false;
+        Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+        nodes = 0;
+        tableHits = 0;
+        lastWasEndgame = false;
+
+        BoardSnapshot snapshot(board);
+        int gridSize = snapshot.getGridSize();
+        probabilityEngine::Method method = rootEngine.compute(snapshot, deadline);
+        if (method == probabilityEngine::NONE) return false;
+        if (method == probabilityEngine::SAMPLED) {
+            int best = -1;
+            for (int index = 0; index < gridSize * gridSize; index++) {
+                if (!snapshot.isUnknown(index)) continue;
+                if (best < 0 || rootEngine.getMineProbability(index) < rootEngine.getMineProbability(best)) best = index;
+            }
+            if (best < 0) return false;
+            guess = {best % gridSize, best / gridSize};
+            lastWinEstimate = 1.0 - rootEngine.getMineProbability(best);
+            return true;
+        }
+
+        const frontierAnalysis& analysis = rootEngine.getExact();
+        if (!analysis.getSafeCells().empty()) {
+            int cell = analysis.getSafeCells().front();
+            guess = {cell % gridSize, cell / gridSize};
+            lastWinEstimate = 1.0;
+            return true;
+        }
+
+        if (endgame.solve(snapshot)) {
+            int cell = endgame.getBestCell();
+            guess = {cell % gridSize, cell / gridSize};
+            lastWinEstimate = endgame.getWinProbability();
+            lastWasEndgame = true;
+            return true;
+        }
+
+        std::vector<int> candidates = pickCandidates(snapshot, analysis);
+        if (candidates.empty()) return false;
+
+        // Candidates are dealt round-robin to the workers, each on its own snapshot copy
+        int active = std::min(threads, static_cast<int>(candidates.size()));
+        workers.resize(std::max(static_cast<int>(workers.size()), active));
+        std::vector<Scored> scored(candidates.size());
+        auto run = [&](int t) {
+            Worker& worker = workers[t];
+            if (worker.table.size() > MAX_TABLE_ENTRIES) worker.table.clear();
+            worker.deadline = deadline;
+            worker.rootMines = static_cast<int>(analysis.getMineCells().size());
+            worker.nodes = 0;
+            worker.tableHits = 0;
+            BoardSnapshot local = snapshot;
+            for (size_t i = t; i < candidates.size(); i += active) {
+                scored[i].safe = worker.scoreGuess(local, analysis, candidates[i], 0);
+                if (Clock::now() > deadline) continue; // Out of time: only the static odds
+                worker.timedOut = false;
+                scored[i].value = worker.scoreGuess(local, analysis, candidates[i], depth - 1, &scored[i].progress);
+                scored[i].done = true;
+                scored[i].complete = !worker.timedOut && Clock::now() <= deadline;
+            }
+        };
+        if (active > 1) {
+            if (!pool) pool = std::make_unique<workerPool>(threads - 1);
+            pool->run(active, run);
+        } else {
+            run(0);
+        }
+
+        // Only fully searched candidates are comparable; without any, every candidate is ranked on P(safe)
+        bool anyComplete = std::any_of(scored.begin(), scored.end(), [](const Scored& entry) { return entry.complete; });
+        int best = -1;
+        double bestScore = -1.0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (anyComplete && !scored[i].complete) continue;
+            double score = anyComplete ? scored[i].value * (1.0 + INFO_WEIGHT * scored[i].progress) : scored[i].safe;
+            if (score > bestScore) {
+                bestScore = score;
+                best = static_cast<int>(i);
+            }
+        }
+        for (int t = 0; t < active; t++) {
+            nodes += workers[t].nodes;
+            tableHits += workers[t].tableHits;
+        }
+        guess = {candidates[best] % gridSize, candidates[best] / gridSize};
+        lastWinEstimate = anyComplete ? scored[best].value : scored[best].safe;
+        return true;
+    }
+
+private:
+    // Lowest mine probability first, ties broken by cell index (the order is fixed; how far
+    // the search gets within the time budget is not)
+    static std::vector<int> pickCandidates(const BoardSnapshot& snapshot, const frontierAnalysis& analysis) {
+        std::vector<int> candidates;
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        for (int index = 0; index < cellCount; index++) {
+            if (snapshot.isUnknown(index)) candidates.push_back(index);
+        }
+        std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+            double pa = analysis.getMineProbability(a);
+            double pb = analysis.getMineProbability(b);
+            return pa != pb ? pa < pb : a < b;
+        });
+        if (candidates.size() > CANDIDATES) candidates.resize(CANDIDATES);
+        return candidates;
+    }
+};
+
+#endif
@@ -0,0 +1,1353 @@
+#include <SFML/Graphics.hpp>
+#include "Board.h"
+#include "BoardRenderer.h"
+#include "ReplayLog.h"
+#include "BoardCorpus.h"
+#include "BoardPool.h"
+#include "GameStats.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "algoSolver.cpp"
+#include "heatmapSolver.cpp"
+#include "noGuessGenerator.cpp"
+#include "winRateTest.cpp"
+
+/**
+ * Headless runner: plays solver games or replays recorded ones without opening a window.
+ *
+ *   ./headless --solver algo|heatmap [--games N] [--size S] [--mines M] [--seed BASE]
+ *              [--corpus FILE] [--range A:B | --worker I/N] [--threads T]
+ *              [--guess-budget MS] [--cache-size N] [--pool N] [--record FILE] [--safe-start] [--first-click-safe]
+ *              [--stats-csv FILE] [--stats-json FILE] [--oracle] [--checkpoint FILE [--checkpoint-every S]]
+ *              [--precision H] [--versus SOLVER [--alpha A]] [--verbose]
+ *   ./headless --tournament [--disagreements FILE] [--games N] [--corpus FILE | --seed BASE] [--range A:B | --worker I/N]
+ *              [--threads T] [--guess-budget MS] [--safe-start]
+ *   ./headless --sweep NAME=V1,V2,.. | NAME=LO:HI [--sweep ...] [--sweep-samples N] [--games N] [--corpus FILE | --seed BASE]
+ *              [--size S] [--mines M] [--threads T] [--guess-budget MS] [--cache-size N] [--safe-start]
+ *   ./headless --replay FILE [--game K] [--verbose]
+ *   ./headless --generate-corpus FILE [--games N] [--size S] [--mines M] [--seed BASE] [--no-guess [--threads T]]
+ *   ./headless --self-check
+ *
+ * Games are numbered; game i uses seed BASE + i, or corpus record i with --corpus.
+ * --range / --worker pick a slice of those games so separate processes can share one corpus.
+ * --no-guess keeps only boards that deduction clears from their start cell (opened by --safe-start).
+ * --first-click-safe places each seeded game's mines on its first reveal, away from that cell.
+ * --cache-size bounds each thread's component cache (stored solutions); the report shows its hit rate.
+ * --stats-csv / --stats-json write the per-game metrics (moves, guesses, deductions by rule,
+ * time quantiles, histograms) merged over all threads.
+ * --pool keeps N seeded games per thread generated ahead on a background thread (0 = generate on reset).
+ * --oracle checks every guess against optimalityOracle and reports the guesses that risked a mine
+ * while some cell was provably safe, and the losses that followed such a guess.
+ * --checkpoint saves finished games and merged totals every S seconds (default 60); running the same
+ * command again resumes after the last saved games. Games in flight when a run is killed are played again
+ * (and appear twice in a --record log).
+ * --precision plays games until the 95% interval on the win rate is within +-H (--games caps the run).
+ * --versus plays SOLVER on the same games as --solver and stops once one is better at level A (default 0.05),
+ * or, with --precision, once the difference between them is known to within +-H.
+ * --sweep tunes heatmapSolver::Params: lists are crossed into a grid, any LO:HI range switches to
+ * --sweep-samples random settings (default 20). Every setting plays the same --games games, ranked by
+ * win rate. The weights only steer guesses the exact search doesn't make, so sweep with --guess-budget 0.
+ * Every other option applies to each setting as it would to a plain run.
+ * --tournament plays every solver in SOLVERS on each game and reports every pair's paired results.
+ * --disagreements writes the boards some solvers won and others lost as a corpus, so they can be
+ * played again with --corpus FILE --record LOG and stepped through with --replay LOG.
+ * --self-check runs quick checks of the win rate statistics, the checkpoint and replay formats, 3BV and
+ * the exact frontier analysis, and exits non-zero if any fails.
+ */
+
+// Every solver the runner knows, in the order tournaments report them
+static const char* const SOLVERS[] = {"algo", "heatmap"};
+
+static bool isSolver(const std::string& name) {
+    return std::find(std::begin(SOLVERS), std::end(SOLVERS), name) != std::end(SOLVERS);
+}
+
+struct HeadlessOptions {
+    std::string solverName = "algo";
+    int games = 100;
+    bool hasGames = false;
+    int gridSize = Board::DEFAULT_GRID_SIZE;
+    int mines = Board::DEFAULT_MINES;
+    bool hasSeed = false;
+    std::uint64_t baseSeed = 0;
+    std::string recordPath;
+    std::string replayPath;
+    int replayGame = -1;
+    std::string corpusPath;
+    std::string generateCorpusPath;
+    std::string statsCsvPath;
+    std::string statsJsonPath;
+    bool hasRange = false;
+    std::uint64_t rangeBegin = 0;
+    std::uint64_t rangeEnd = 0;
+    int workerIndex = 0;
+    int workerCount = 1;
+    int threads = 1;
+    bool hasThreads = false;
+    double guessBudgetMs = guessSearch::DEFAULT_BUDGET_MS;
+    size_t cacheSize = componentCache::DEFAULT_CAPACITY;
+    size_t pool = 0;
+    bool safeStart = false;
+    bool firstClickSafe = false;
+    bool noGuess = false;
+    bool verbose = false;
+    bool oracle = false;
+    double precision = 0.0; // Target half-width of the win rate interval; 0 = play a fixed number of games
+    std::string versusName;
+    double alpha = 0.05;
+    std::vector<std::string> sweep; // NAME=values, one per swept parameter
+    int sweepSamples = 0;
+    std::string checkpointPath;
+    double checkpointSeconds = 60.0;
+    bool tournament = false;
+    std::string disagreementsPath;
+    bool selfCheck = false;
+};
+
+static bool parseOptions(int argc, char* argv[], HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--solver" && hasValue) options.solverName = argv[++i];
+        else if (arg == "--games" && hasValue) { options.games = std::atoi(argv[++i]); options.hasGames = true; }
+        else if (arg == "--size" && hasValue) options.gridSize = std::atoi(argv[++i]);
+        else if (arg == "--mines" && hasValue) options.mines = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) { options.baseSeed = std::strtoull(argv[++i], nullptr, 10); options.hasSeed = true; }
+        else if (arg == "--record" && hasValue) options.recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) options.replayPath = argv[++i];
+        else if (arg == "--game" && hasValue) options.replayGame = std::atoi(argv[++i]);
+        else if (arg == "--corpus" && hasValue) options.corpusPath = argv[++i];
+        else if (arg == "--generate-corpus" && hasValue) options.generateCorpusPath = argv[++i];
+        else if (arg == "--stats-csv" && hasValue) options.statsCsvPath = argv[++i];
+        else if (arg == "--stats-json" && hasValue) options.statsJsonPath = argv[++i];
+        else if (arg == "--guess-budget" && hasValue) options.guessBudgetMs = std::atof(argv[++i]);
+        else if (arg == "--cache-size" && hasValue) options.cacheSize = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--pool" && hasValue) options.pool = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--precision" && hasValue) options.precision = std::atof(argv[++i]);
+        else if (arg == "--versus" && hasValue) options.versusName = argv[++i];
+        else if (arg == "--alpha" && hasValue) options.alpha = std::atof(argv[++i]);
+        else if (arg == "--sweep" && hasValue) options.sweep.push_back(argv[++i]);
+        else if (arg == "--checkpoint" && hasValue) options.checkpointPath = argv[++i];
+        else if (arg == "--checkpoint-every" && hasValue) options.checkpointSeconds = std::max(1.0, std::atof(argv[++i]));
+        else if (arg == "--tournament") options.tournament = true;
+        else if (arg == "--disagreements" && hasValue) options.disagreementsPath = argv[++i];
+        else if (arg == "--sweep-samples" && hasValue) options.sweepSamples = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) { options.threads = std::max(1, std::atoi(argv[++i])); options.hasThreads = true; }
+        else if (arg == "--range" && hasValue) {
+            std::string range = argv[++i];
+            size_t colon = range.find(':');
+            if (colon == std::string::npos) return false;
+            options.rangeBegin = std::strtoull(range.substr(0, colon).c_str(), nullptr, 10);
+            options.rangeEnd = std::strtoull(range.substr(colon + 1).c_str(), nullptr, 10);
+            options.hasRange = true;
+        }
+        else if (arg == "--worker" && hasValue) {
+            std::string worker = argv[++i];
+            size_t slash = worker.find('/');
+            if (slash == std::string::npos) return false;
+            options.workerIndex = std::atoi(worker.substr(0, slash).c_str());
+            options.workerCount = std::max(1, std::atoi(worker.substr(slash + 1).c_str()));
+        }
+        else if (arg == "--safe-start") options.safeStart = true;
+        else if (arg == "--first-click-safe") options.firstClickSafe = true;
+        else if (arg == "--no-guess") options.noGuess = true;
+        else if (arg == "--verbose") options.verbose = true;
+        else if (arg == "--oracle") options.oracle = true;
+        else if (arg == "--self-check") options.selfCheck = true;
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.threads > 1 && !options.recordPath.empty()) {
+        std::cerr << "--record needs a single thread" << std::endl;
+        return false;
+    }
+    if ((options.precision > 0 || !options.versusName.empty()) && (!options.recordPath.empty() || options.hasRange || options.workerCount > 1)) {
+        std::cerr << "--precision and --versus pick their own games; they can't be combined with --record, --range or --worker" << std::endl;
+        return false;
+    }
+    if (!options.sweep.empty() && (!options.recordPath.empty() || options.hasRange || options.workerCount > 1 || options.precision > 0 || !options.versusName.empty())) {
+        std::cerr << "--sweep plays its own games; it can't be combined with --record, --range, --worker, --precision or --versus" << std::endl;
+        return false;
+    }
+    if (options.tournament && (!options.recordPath.empty() || options.firstClickSafe || options.precision > 0 || !options.versusName.empty() || !options.sweep.empty())) {
+        // First-click-safe boards place their mines around each solver's own first click, so they wouldn't be identical
+        std::cerr << "--tournament can't be combined with --record, --first-click-safe, --precision, --versus or --sweep" << std::endl;
+        return false;
+    }
+    if (options.firstClickSafe && (!options.versusName.empty() || !options.sweep.empty())) {
+        // Likewise: --versus and --sweep promise every solver or setting the same boards
+        std::cerr << "--first-click-safe can't be combined with --versus or --sweep" << std::endl;
+        return false;
+    }
+    bool ownGames = options.precision > 0 || !options.versusName.empty() || !options.sweep.empty() || options.tournament;
+    if (ownGames && (!options.checkpointPath.empty() || !options.statsCsvPath.empty() || !options.statsJsonPath.empty()
+                     || options.oracle || options.pool > 0)) {
+        std::cerr << "--checkpoint, --stats-csv, --stats-json, --oracle and --pool only apply to a plain run, not to --precision, "
+                  << "--versus, --sweep or --tournament" << std::endl;
+        return false;
+    }
+    if (options.alpha <= 0 || options.alpha >= 1) {
+        std::cerr << "--alpha must be between 0 and 1" << std::endl;
+        return false;
+    }
+    if (options.gridSize < 2 || options.mines < 1 || options.mines >= options.gridSize * options.gridSize) {
+        std::cerr << "Invalid board: " << options.gridSize << "x" << options.gridSize << " with " << options.mines << " mines" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int runReplay(const HeadlessOptions& options, std::ostream& out) {
+    Board board;
+    ReplayPlayer player(board);
+    if (!player.open(options.replayPath)) {
+        std::cerr << "Could not read replay log " << options.replayPath << std::endl;
+        return 1;
+    }
+
+    int games = 0;
+    int mismatches = 0;
+    long long moves = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    bool loaded = options.replayGame >= 0 ? player.skipToGame(options.replayGame) : player.loadNextGame();
+    while (loaded) {
+        moves += player.step(INT_MAX);
+        games++;
+
+        const replayLog::GameRecord& game = player.getCurrentGame();
+        bool matches = player.resultMatches();
+        if (!matches) mismatches++;
+
+        // Losses and divergences are the games worth looking at
+        if (options.replayGame >= 0 || board.getGameState() == IBoardSolver::LOST || !matches) {
+            out << "game " << (player.getGameNumber() - 1) << " seed=" << game.seed
+                << " size=" << game.gridSize << " mines=" << game.mines
+                << " moves=" << game.moves.size()
+                << " result=" << (board.getGameState() == IBoardSolver::WON ? "WON" : board.getGameState() == IBoardSolver::LOST ? "LOST" : "UNFINISHED")
+                << (game.complete ? "" : " (truncated)")
+                << (matches ? "" : " MISMATCH") << "\n";
+        }
+        if (options.replayGame >= 0) break;
+        loaded = player.loadNextGame();
+    }
+
+    double elapsed = secondsSince(start);
+    out << "Replayed " << games << " games, " << moves << " moves in " << elapsed << "s ("
+        << (elapsed > 0 ? moves / elapsed : 0.0) << " moves/s), " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+// Keeps the lowest-seeded boards that deduction alone can clear
+static int runNoGuessGeneration(const HeadlessOptions& options, std::ostream& out) {
+    std::uint64_t baseSeed = options.hasSeed ? options.baseSeed : std::random_device{}();
+    noGuessGenerator generator;
+    if (options.hasThreads) generator.setThreads(options.threads); // Otherwise every core
+    std::vector<boardCorpus::Layout> layouts = generator.generate(options.gridSize, options.mines, baseSeed, options.games);
+    if (!boardCorpus::write(options.generateCorpusPath, options.gridSize, options.mines, layouts)) {
+        std::cerr << "Could not write corpus " << options.generateCorpusPath << std::endl;
+        return 1;
+    }
+
+    const noGuessGenerator::Stats& stats = generator.getStats();
+    out << "Generated " << layouts.size() << " no-guess boards (seeds " << baseSeed << ".."
+        << (layouts.empty() ? baseSeed : layouts.back().seed) << ") from " << stats.candidates << " candidates in "
+        << stats.seconds << "s (" << stats.boardsPerSecond() << " boards/s, "
+        << (stats.seconds > 0 ? stats.candidates / stats.seconds : 0.0) << " candidates/s)\n";
+    out << "Rejected: " << stats.needsGuess << " need a guess, " << stats.noOpening << " have no opening, "
+        << stats.tooHard << " too big to analyse" << std::endl;
+    if (stats.gaveUp) {
+        out << "Gave up after " << stats.candidates << " candidates: no-guess boards are too rare at " << options.gridSize
+            << "x" << options.gridSize << " with " << options.mines << " mines (" << layouts.size() << " of " << options.games
+            << " found)" << std::endl;
+    }
+    return 0;
+}
+
+struct DifficultyTally {
+    int wins = 0;
+    int played = 0;
+};
+
+struct RunTotals {
+    int wins = 0;
+    int losses = 0;
+    int abandoned = 0;
+    std::map<int, DifficultyTally> byThreeBV; // Finished games by the board's 3BV
+    componentCache::Stats cache;
+    BoardPool::Stats pool;
+    std::unique_ptr<GameStats> stats; // The solver's, copied out once its games are done
+};
+
+template <typename Solver>
+static void configureSolver(Solver& solver, const HeadlessOptions& options) {
+    solver.setTurbo(true);
+    solver.setSafeStart(options.safeStart);
+    solver.setGuessBudget(options.guessBudgetMs);
+    solver.setOracle(options.oracle);
+    // Share the cores between worker threads instead of every sampler using all of them
+    solver.setGuessThreads(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / options.threads));
+    componentCache::local().setCapacity(options.cacheSize);
+}
+
+// Plays the board's next game to the end (or the step limit)
+template <typename Solver>
+static void playGame(Solver& solver, Board& board, long long maxSteps) {
+    solver.restartGame(); // Also counts the previous game inside the solver
+    solverUtilities::seed(board.getSeed()); // Random moves depend on the game, not on the games before it
+    long long steps = 0;
+    while (!board.isGameOver() && solver.isActive() && steps < maxSteps) {
+        solver.makeMove();
+        steps++;
+    }
+}
+
+// Has the board load game number `game` on every reset (corpus record or seed BASE + game),
+// set up as the options ask. Modes that compare solvers on these boards refuse --first-click-safe,
+// whose mines follow each solver's own first click
+static void loadNumberedGames(Board& board, const HeadlessOptions& options, const CorpusReader* corpus,
+                              std::uint64_t baseSeed, const std::uint64_t& game) {
+    if (corpus) {
+        board.setLayoutSource([corpus, &game](Board& target) {
+            corpus->loadInto(target, game);
+            return true;
+        });
+    } else {
+        board.setSeedSource([baseSeed, &game]() { return baseSeed + game; });
+    }
+    board.setFirstClickSafe(options.firstClickSafe);
+}
+
+// Runs `body` with a solver of the named kind on the board
+template <typename Body>
+static void withSolver(const std::string& name, Board& board, Body&& body) {
+    if (name == "algo") {
+        algoSolver solver(board, nullptr);
+        body(solver);
+    } else {
+        heatmapSolver solver(board, nullptr);
+        body(solver);
+    }
+}
+
+template <typename Solver>
+static RunTotals playGames(Solver& solver, Board& board, const HeadlessOptions& options, std::uint64_t games) {
+    // Bound steps per game so a solver that stops making progress can't hang the run
+    const long long maxStepsPerGame = 16LL * board.getGridSize() * board.getGridSize() + 100;
+    RunTotals totals;
+    configureSolver(solver, options);
+
+    for (std::uint64_t game = 0; game < games; game++) {
+        playGame(solver, board, maxStepsPerGame);
+        if (board.getGameState() == IBoardSolver::WON) totals.wins++;
+        else if (board.getGameState() == IBoardSolver::LOST) totals.losses++;
+        else totals.abandoned++;
+        if (board.isGameOver()) {
+            DifficultyTally& tally = totals.byThreeBV[board.getDifficulty().threeBV];
+            tally.played++;
+            tally.wins += board.getGameState() == IBoardSolver::WON;
+        }
+    }
+    solver.countFinishedGame(); // The last game is otherwise only counted by the next reset
+    totals.stats = std::make_unique<GameStats>(board.getGridSize());
+    totals.stats->merge(solver.getStats());
+    return totals;
+}
+
+// Writes the merged metrics if a path was given; false if it could not be written
+static bool writeStats(const std::string& path, const GameStats& stats, bool json) {
+    if (path.empty()) return true;
+    std::ofstream file(path);
+    if (json) stats.writeJson(file);
+    else stats.writeCsv(file);
+    if (file) return true;
+    std::cerr << "Could not write statistics to " << path << std::endl;
+    return false;
+}
+
+// Win rate per 3BV range, about BUCKETS rows wide so it stays readable at any board size
+static void printWinRateByDifficulty(const std::map<int, DifficultyTally>& byThreeBV, std::ostream& out) {
+    const int BUCKETS = 8;
+    if (byThreeBV.empty()) return;
+    int lowest = byThreeBV.begin()->first, highest = byThreeBV.rbegin()->first;
+    int width = std::max(1, (highest - lowest + BUCKETS) / BUCKETS);
+    out << "Win rate by 3BV:\n";
+    auto entry = byThreeBV.begin();
+    for (int from = lowest; from <= highest; from += width) {
+        DifficultyTally bucket;
+        for (; entry != byThreeBV.end() && entry->first < from + width; ++entry) {
+            bucket.wins += entry->second.wins;
+            bucket.played += entry->second.played;
+        }
+        if (bucket.played == 0) continue;
+        out << "  " << from << "-" << (from + width - 1) << ": " << bucket.played << " games, "
+            << 100.0 * bucket.wins / bucket.played << "%\n";
+    }
+}
+
+// Works out which slice [begin, end) of the numbered games this process plays
+static void gameSlice(const HeadlessOptions& options, const CorpusReader* corpus, std::uint64_t& begin, std::uint64_t& end) {
+    std::uint64_t total = options.games;
+    if (corpus) total = options.hasGames ? std::min<std::uint64_t>(corpus->size(), options.games) : corpus->size();
+    begin = total * options.workerIndex / options.workerCount;
+    end = total * (options.workerIndex + 1) / options.workerCount;
+    if (options.hasRange) {
+        begin = options.rangeBegin;
+        end = corpus ? std::min<std::uint64_t>(options.rangeEnd, corpus->size()) : options.rangeEnd;
+    }
+    if (end < begin) end = begin;
+}
+
+// Plays games [begin, end) on a private board and solver
+static RunTotals runWorker(const HeadlessOptions& options, const CorpusReader* corpus,
+                           std::uint64_t begin, std::uint64_t end, ReplayWriter* writer) {
+    int gridSize = corpus ? corpus->getGridSize() : options.gridSize;
+    int mines = corpus ? corpus->getMines() : options.mines;
+    Board board(gridSize, mines);
+
+    std::uint64_t next = begin;
+    std::function<std::uint64_t()> seeds;
+    if (corpus) {
+        board.setLayoutSource([corpus, next, end](Board& target) mutable {
+            if (next >= end) return false;
+            corpus->loadInto(target, next++);
+            return true;
+        });
+    } else if (options.hasSeed) {
+        std::uint64_t baseSeed = options.baseSeed;
+        seeds = [baseSeed, next]() mutable { return baseSeed + next++; };
+    } else if (options.pool > 0) {
+        seeds = std::mt19937_64(std::random_device{}());
+    }
+    board.setFirstClickSafe(options.firstClickSafe);
+
+    // The pool takes over the seed sequence, so pooled and unpooled runs play the same games
+    std::unique_ptr<BoardPool> pool;
+    if (!corpus && options.pool > 0) {
+        pool = std::make_unique<BoardPool>(gridSize, mines, options.firstClickSafe, seeds, options.pool);
+        pool->attach(board);
+    } else if (seeds) {
+        board.setSeedSource(seeds);
+    }
+    if (writer) board.setRecorder(writer);
+
+    RunTotals totals;
+    withSolver(options.solverName, board, [&](auto& solver) { totals = playGames(solver, board, options, end - begin); });
+    if (pool) totals.pool = pool->getStats();
+    return totals;
+}
+
+static void mergeTotals(RunTotals& totals, const RunTotals& result) {
+    totals.stats->merge(*result.stats);
+    totals.wins += result.wins;
+    totals.losses += result.losses;
+    totals.abandoned += result.abandoned;
+    totals.pool.taken += result.pool.taken;
+    totals.pool.stalls += result.pool.stalls;
+    for (const auto& [threeBV, tally] : result.byThreeBV) {
+        totals.byThreeBV[threeBV].wins += tally.wins;
+        totals.byThreeBV[threeBV].played += tally.played;
+    }
+}
+
+using GameRange = std::pair<std::uint64_t, std::uint64_t>; // Games [first, second)
+
+// Adds a range to a sorted list of disjoint ranges, joining neighbours
+static void addRange(std::vector<GameRange>& ranges, GameRange range) {
+    ranges.insert(std::upper_bound(ranges.begin(), ranges.end(), range), range);
+    std::vector<GameRange> joined;
+    for (const GameRange& next : ranges) {
+        if (!joined.empty() && next.first <= joined.back().second) joined.back().second = std::max(joined.back().second, next.second);
+        else joined.push_back(next);
+    }
+    ranges.swap(joined);
+}
+
+static std::uint64_t rangeGames(const std::vector<GameRange>& ranges) {
+    std::uint64_t games = 0;
+    for (const GameRange& range : ranges) games += range.second - range.first;
+    return games;
+}
+
+/**
+ * Checkpoint file: plain text, rewritten whole every --checkpoint-every seconds.
+ *
+ *   MSCK 2
+ *   run SOLVER size S mines M games B..E [corpus PATH] safe-start .. first-click-safe .. guess-budget .. oracle ..
+ *   seed BASE
+ *   done N first second ...   (finished game ranges)
+ *   totals WINS LOSSES ABANDONED
+ *   threebv N threeBV wins played ...
+ *   games wins moves guesses micros missedSafeMoves lostAfterMiss uncheckedGuesses
+ *   <deductions per rule, then the time sketch and histograms of GameStats::writeState>
+ *
+ * Version 2 added the oracle counters to the GameStats line and oracle to the run key;
+ * a version 1 file is refused rather than misread.
+ *
+ * Every game's board (and first-click mine placement) follows from its number and the base
+ * seed, so the base seed is all the random state a resumed run needs. The new contents go to
+ * FILE.tmp, are synced and then renamed over FILE, so a crash leaves the old or the new checkpoint.
+ */
+static const char CHECKPOINT_MAGIC[] = "MSCK 2";
+static const std::uint64_t CHECKPOINT_CHUNK_GAMES = 256; // Lost at most per thread when killed
+
+static std::string checkpointKey(const HeadlessOptions& options, std::uint64_t begin, std::uint64_t end) {
+    std::ostringstream key;
+    key << "run " << options.solverName << " size " << options.gridSize << " mines " << options.mines << " games " << begin << ".." << end
+        << (options.corpusPath.empty() ? "" : " corpus " + options.corpusPath) << " safe-start " << options.safeStart
+        << " first-click-safe " << options.firstClickSafe << " guess-budget " << options.guessBudgetMs << " oracle " << options.oracle;
+    return key.str();
+}
+
+static std::string checkpointText(const std::string& key, const HeadlessOptions& options,
+                                  const RunTotals& totals, const std::vector<GameRange>& done) {
+    std::ostringstream text;
+    text << CHECKPOINT_MAGIC << "\n" << key << "\nseed " << options.baseSeed << "\ndone " << done.size();
+    for (const GameRange& range : done) text << " " << range.first << " " << range.second;
+    text << "\ntotals " << totals.wins << " " << totals.losses << " " << totals.abandoned << "\nthreebv " << totals.byThreeBV.size();
+    for (const auto& [threeBV, tally] : totals.byThreeBV) text << " " << threeBV << " " << tally.wins << " " << tally.played;
+    text << "\n";
+    totals.stats->writeState(text);
+    return text.str();
+}
+
+// Replaces the checkpoint file atomically; done outside totalsMutex so workers keep going
+static bool writeCheckpoint(const std::string& path, const std::string& contents) {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    bool written = file && std::fwrite(contents.data(), 1, contents.size(), file) == contents.size()
+                   && std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (file) written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Could not write checkpoint " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Loads a checkpoint of the same run; takes its base seed unless one was given
+static bool readCheckpoint(const std::string& path, const std::string& key, bool seedGiven, HeadlessOptions& options,
+                           RunTotals& totals, std::vector<GameRange>& done) {
+    std::ifstream file(path);
+    std::string magic, savedKey, label;
+    std::getline(file, magic);
+    std::getline(file, savedKey);
+    if (magic != CHECKPOINT_MAGIC || savedKey != key) {
+        std::cerr << "Checkpoint " << path << " is from a different run:\n  " << savedKey << "\nnot\n  " << key << std::endl;
+        return false;
+    }
+    std::uint64_t seed = 0;
+    size_t count = 0;
+    bool valid = static_cast<bool>(file >> label >> seed) && label == "seed" && (!seedGiven || seed == options.baseSeed || !options.corpusPath.empty());
+    valid = valid && file >> label >> count && label == "done";
+    for (size_t i = 0; valid && i < count; i++) {
+        GameRange range;
+        valid = file >> range.first >> range.second && range.first <= range.second;
+        if (valid) addRange(done, range);
+    }
+    valid = valid && file >> label >> totals.wins >> totals.losses >> totals.abandoned && label == "totals";
+    valid = valid && file >> label >> count && label == "threebv";
+    for (size_t i = 0; valid && i < count; i++) {
+        int threeBV = 0;
+        DifficultyTally tally;
+        valid = static_cast<bool>(file >> threeBV >> tally.wins >> tally.played);
+        totals.byThreeBV[threeBV] = tally;
+    }
+    if (!valid || !totals.stats->readState(file)) {
+        std::cerr << "Checkpoint " << path << " is damaged or has a different seed" << std::endl;
+        return false;
+    }
+    options.baseSeed = seed;
+    return true;
+}
+
+static int runSolvers(const HeadlessOptions& options, std::ostream& out) {
+    if (!isSolver(options.solverName)) {
+        std::cerr << "Unknown solver: " << options.solverName << std::endl;
+        return 1;
+    }
+
+    CorpusReader corpus;
+    if (!options.corpusPath.empty() && !corpus.open(options.corpusPath)) {
+        std::cerr << "Could not map corpus " << options.corpusPath << std::endl;
+        return 1;
+    }
+    bool useCorpus = !options.corpusPath.empty();
+    std::uint64_t begin, end;
+    gameSlice(options, useCorpus ? &corpus : nullptr, begin, end);
+
+    // Checkpointed runs pick their seeds up front, so the remaining games are known on resume
+    HeadlessOptions runOptions = options;
+    bool checkpointing = !options.checkpointPath.empty();
+    if (checkpointing && !useCorpus && !options.hasSeed) {
+        runOptions.hasSeed = true;
+        runOptions.baseSeed = std::random_device{}();
+    }
+    std::string key = checkpointKey(runOptions, begin, end);
+
+    RunTotals totals;
+    totals.stats = std::make_unique<GameStats>(useCorpus ? corpus.getGridSize() : options.gridSize);
+    std::vector<GameRange> done;
+    if (checkpointing && std::ifstream(options.checkpointPath)) {
+        if (!readCheckpoint(options.checkpointPath, key, options.hasSeed, runOptions, totals, done)) return 1;
+        out << "Resuming from " << options.checkpointPath << ": " << rangeGames(done) << " of " << (end - begin) << " games done\n";
+    }
+
+    ReplayWriter writer;
+    if (!options.recordPath.empty() && !writer.open(options.recordPath)) {
+        std::cerr << "Could not open replay log " << options.recordPath << std::endl;
+        return 1;
+    }
+
+    // Cut what is left into chunks: one per thread, or small ones so a checkpoint loses little
+    std::vector<GameRange> chunks;
+    std::uint64_t remaining = (end - begin) - rangeGames(done);
+    std::uint64_t chunkSize = checkpointing ? CHECKPOINT_CHUNK_GAMES : std::max<std::uint64_t>(1, (remaining + options.threads - 1) / options.threads);
+    std::uint64_t next = begin;
+    for (size_t i = 0; i <= done.size(); i++) {
+        std::uint64_t pendingEnd = i < done.size() ? done[i].first : end;
+        for (; next < pendingEnd; next = std::min(pendingEnd, next + chunkSize)) chunks.push_back({next, std::min(pendingEnd, next + chunkSize)});
+        if (i < done.size()) next = done[i].second;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Workers claim chunks, each played on a fresh board and solver, and fold them into the totals
+    std::atomic<size_t> nextChunk{0};
+    std::mutex totalsMutex;
+    std::condition_variable finished;
+    int running = options.threads;
+    size_t mostHeld = 0; // By one thread's cache; totals.cache.held sums them all
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; t++) {
+        workers.emplace_back([&]() {
+            for (size_t c; (c = nextChunk.fetch_add(1)) < chunks.size();) {
+                RunTotals result = runWorker(runOptions, useCorpus ? &corpus : nullptr, chunks[c].first, chunks[c].second,
+                                             writer.isOpen() ? &writer : nullptr);
+                std::lock_guard<std::mutex> lock(totalsMutex);
+                mergeTotals(totals, result);
+                addRange(done, chunks[c]);
+            }
+            std::lock_guard<std::mutex> lock(totalsMutex);
+            // The cache lives as long as the thread, so its counts are taken once at the end
+            componentCache::Stats cache = componentCache::local().getStats();
+            totals.cache.hits += cache.hits;
+            totals.cache.misses += cache.misses;
+            totals.cache.evictions += cache.evictions;
+            totals.cache.entries += cache.entries;
+            totals.cache.held += cache.held;
+            mostHeld = std::max(mostHeld, cache.held);
+            running--;
+            finished.notify_one();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(totalsMutex);
+        auto interval = std::chrono::duration<double>(options.checkpointSeconds);
+        while (running > 0) {
+            if (!checkpointing) finished.wait(lock, [&]() { return running == 0; });
+            else if (!finished.wait_for(lock, interval, [&]() { return running == 0; })) {
+                std::string contents = checkpointText(key, runOptions, totals, done);
+                lock.unlock();
+                writeCheckpoint(options.checkpointPath, contents);
+                lock.lock();
+            }
+        }
+    }
+    for (auto& worker : workers) worker.join();
+    if (checkpointing && !writeCheckpoint(options.checkpointPath, checkpointText(key, runOptions, totals, done))) return 1;
+
+    double elapsed = secondsSince(start);
+    int played = totals.wins + totals.losses;
+    std::uint64_t games = end - begin;
+    out << "Solver: " << options.solverName << " games " << begin << ".." << end
+        << (useCorpus ? " of corpus " + options.corpusPath : std::string()) << "\n";
+    out << "Games: " << games << " wins: " << totals.wins << " losses: " << totals.losses << " abandoned: " << totals.abandoned << "\n";
+    out << "Win rate: " << (played > 0 ? 100.0 * totals.wins / played : 0.0) << "%\n";
+    out << "Component cache: " << totals.cache.hits << " hits / " << (totals.cache.hits + totals.cache.misses) << " lookups ("
+        << 100.0 * totals.cache.hitRate() << "%), " << totals.cache.entries << " entries holding " << totals.cache.held
+        << " in total, at most " << mostHeld << " of " << options.cacheSize << " on one thread, " << totals.cache.evictions
+        << " evictions\n";
+    if (options.pool > 0 && !useCorpus) {
+        out << "Board pool: " << totals.pool.taken << " games taken, " << totals.pool.stalls << " waited for the producer ("
+            << options.pool << " per thread)\n";
+    }
+    printWinRateByDifficulty(totals.byThreeBV, out);
+    const GameStats& stats = *totals.stats;
+    if (stats.getGames() > 0) {
+        out << "Per game: " << static_cast<double>(stats.getMoves()) / stats.getGames() << " moves, "
+            << static_cast<double>(stats.getGuesses()) / stats.getGames() << " guesses, time p50 "
+            << 1000.0 * stats.timeQuantile(0.5) << "ms p99 " << 1000.0 * stats.timeQuantile(0.99) << "ms\n";
+        out << "Deductions:";
+        for (int rule = 0; rule < GameMetrics::RULE_COUNT; rule++) {
+            if (stats.getDeductions(rule) > 0) out << " " << GameMetrics::ruleName(rule) << "=" << stats.getDeductions(rule);
+        }
+        out << "\n";
+    }
+    if (options.oracle && stats.getGames() > 0) {
+        out << "Oracle: " << stats.getMissedSafeMoves() << " of " << stats.getGuesses() << " guesses risked a mine while a safe cell was provable ("
+            << static_cast<double>(stats.getMissedSafeMoves()) / stats.getGames() << " per game), " << stats.getLostAfterMiss() << " of "
+            << (stats.getGames() - stats.getWins()) << " losses followed one; " << stats.getUncheckedGuesses()
+            << " guesses too big for the exact check\n";
+    }
+    if (!writeStats(options.statsCsvPath, stats, false) || !writeStats(options.statsJsonPath, stats, true)) return 1;
+    out << "Time: " << elapsed << "s (" << (elapsed > 0 ? remaining / elapsed : 0.0) << " games/s)" << std::endl;
+    return 0;
+}
+
+// Results of a sequential run. Frozen once a stopping rule fires, so the report describes
+// exactly the games the decision was made on (games still running on other threads are dropped)
+struct SequentialTally {
+    static const std::uint64_t MIN_GAMES = 100; // Fewer and the interval itself is too rough to stop on
+
+    bool versus = false;
+    double precision = 0.0;
+    double alpha = 0.05;
+    std::uint64_t wins = 0;
+    std::uint64_t games = 0;
+    winRateTest::Paired paired;
+    bool stopped = false;
+    bool significant = false; // Stopped by the sequential test rather than by precision
+    std::string reason = "reached the game cap";
+
+    // Adds a finished game unless the run has already stopped
+    void add(bool wonA, bool wonB) {
+        if (stopped) return;
+        games++;
+        wins += wonA;
+        if (versus) paired.add(wonA, wonB);
+        if (games < MIN_GAMES) return;
+        if (versus && paired.significant(alpha)) {
+            reason = "significant at alpha " + std::to_string(alpha);
+            stopped = significant = true;
+        } else if (precision > 0) {
+            double halfWidth = versus ? paired.difference().halfWidth : winRateTest::wilson(wins, games).halfWidth;
+            if (halfWidth <= precision) {
+                reason = "reached precision " + std::to_string(precision);
+                stopped = true;
+            }
+        }
+    }
+};
+
+// Plays numbered games until the win rate (or the difference between two solvers) is known well enough
+static int runSequential(const HeadlessOptions& options, std::ostream& out) {
+    const std::uint64_t DEFAULT_CAP = 1000000;
+
+    bool versus = !options.versusName.empty();
+    for (const std::string& name : {options.solverName, options.versusName}) {
+        if (name.empty() || isSolver(name)) continue;
+        std::cerr << "Unknown solver: " << name << std::endl;
+        return 1;
+    }
+
+    CorpusReader corpus;
+    bool useCorpus = !options.corpusPath.empty();
+    if (useCorpus && !corpus.open(options.corpusPath)) {
+        std::cerr << "Could not map corpus " << options.corpusPath << std::endl;
+        return 1;
+    }
+    std::uint64_t cap = options.hasGames ? static_cast<std::uint64_t>(std::max(0, options.games)) : DEFAULT_CAP;
+    if (useCorpus) cap = std::min<std::uint64_t>(cap, corpus.size());
+    int gridSize = useCorpus ? corpus.getGridSize() : options.gridSize;
+    int mines = useCorpus ? corpus.getMines() : options.mines;
+    std::uint64_t baseSeed = options.hasSeed ? options.baseSeed : std::random_device{}();
+
+    // Workers claim game numbers in order but finish them out of order (losses end sooner),
+    // so results wait in `finished` until every lower game is in. The tally then always
+    // holds games 0..tally.games, and the stopping rule never sees a sample skewed to losses
+    std::atomic<std::uint64_t> claimed{0};
+    std::atomic<bool> stop{false};
+    std::mutex tallyMutex;
+    std::map<std::uint64_t, std::pair<bool, bool>> finished; // By game number, not yet tallied
+    std::uint64_t nextToTally = 0;
+    SequentialTally tally;
+    tally.versus = versus;
+    tally.precision = options.precision;
+    tally.alpha = options.alpha;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; t++) {
+        workers.emplace_back([&]() {
+            const long long maxSteps = 16LL * gridSize * gridSize + 100;
+            std::uint64_t current = 0;
+            // Both boards load the claimed game, so A and B see identical layouts
+            Board boardA(gridSize, mines), boardB(gridSize, mines);
+            loadNumberedGames(boardA, options, useCorpus ? &corpus : nullptr, baseSeed, current);
+            loadNumberedGames(boardB, options, useCorpus ? &corpus : nullptr, baseSeed, current);
+            withSolver(options.solverName, boardA, [&](auto& solverA) {
+                configureSolver(solverA, options);
+                withSolver(versus ? options.versusName : options.solverName, boardB, [&](auto& solverB) {
+                    configureSolver(solverB, options);
+                    while (!stop.load() && (current = claimed.fetch_add(1)) < cap) {
+                        playGame(solverA, boardA, maxSteps);
+                        bool wonA = boardA.getGameState() == IBoardSolver::WON; // Abandoned games count as lost
+                        bool wonB = false;
+                        if (versus) {
+                            playGame(solverB, boardB, maxSteps);
+                            wonB = boardB.getGameState() == IBoardSolver::WON;
+                        }
+                        std::lock_guard<std::mutex> lock(tallyMutex);
+                        finished[current] = {wonA, wonB};
+                        for (auto next = finished.begin(); next != finished.end() && next->first == nextToTally; next = finished.erase(next)) {
+                            tally.add(next->second.first, next->second.second);
+                            nextToTally++;
+                        }
+                        if (tally.stopped) stop.store(true);
+                    }
+                });
+            });
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double elapsed = secondsSince(start);
+
+    std::uint64_t played = std::min(claimed.load(), cap);
+    const winRateTest::Paired& paired = tally.paired;
+    std::uint64_t games = tally.games;
+    out << "Games: " << games << " counted of " << played << " played (" << (useCorpus ? "corpus " + options.corpusPath + " records" : "seeds " + std::to_string(baseSeed) + " +")
+        << " 0.." << games << " counted), stopped: " << tally.reason << "\n";
+    winRateTest::Interval rateA = winRateTest::wilson(tally.wins, games);
+    out << "Solver: " << options.solverName << " win rate " << 100.0 * rateA.centre << "% +- " << 100.0 * rateA.halfWidth << "%\n";
+    if (versus) {
+        winRateTest::Interval rateB = winRateTest::wilson(paired.both + paired.onlyB, games);
+        winRateTest::Interval difference = paired.difference();
+        out << "Versus: " << options.versusName << " win rate " << 100.0 * rateB.centre << "% +- " << 100.0 * rateB.halfWidth << "%\n";
+        out << "Paired: both won " << paired.both << ", only " << options.solverName << " " << paired.onlyA << ", only "
+            << options.versusName << " " << paired.onlyB << ", neither " << paired.neither << "\n";
+        out << "Difference: " << 100.0 * difference.centre << "% +- " << 100.0 * difference.halfWidth
+            << "%, likelihood ratio " << std::exp(paired.logLikelihoodRatio()) << " (threshold " << 1.0 / options.alpha << ")\n";
+        if (tally.significant) {
+            out << "Verdict: " << (paired.onlyA > paired.onlyB ? options.solverName : options.versusName) << " is better\n";
+        } else {
+            out << "Verdict: no significant difference\n";
+        }
+    }
+    out << "Time: " << elapsed << "s (" << (elapsed > 0 ? played / elapsed : 0.0) << " games/s)" << std::endl;
+    return 0;
+}
+
+// One solver on its own board, set up to play whatever game the board loads next
+struct Contestant {
+    std::unique_ptr<Board> board;
+    std::function<bool()> play; // Plays the next game; true if it was won
+};
+
+template <typename Solver>
+static std::function<bool()> playWith(Board& board, const HeadlessOptions& options) {
+    auto solver = std::make_shared<Solver>(board, nullptr);
+    configureSolver(*solver, options);
+    const long long maxSteps = 16LL * board.getGridSize() * board.getGridSize() + 100;
+    return [solver, &board, maxSteps]() {
+        playGame(*solver, board, maxSteps);
+        return board.getGameState() == IBoardSolver::WON; // Abandoned games count as lost
+    };
+}
+
+// Plays every solver on the same games and compares each pair on the boards they shared
+static int runTournament(const HeadlessOptions& options, std::ostream& out) {
+    const size_t SHOWN_DISAGREEMENTS = 20;
+    const size_t solverCount = std::size(SOLVERS);
+
+    CorpusReader corpus;
+    bool useCorpus = !options.corpusPath.empty();
+    if (useCorpus && !corpus.open(options.corpusPath)) {
+        std::cerr << "Could not map corpus " << options.corpusPath << std::endl;
+        return 1;
+    }
+    std::uint64_t begin, end;
+    gameSlice(options, useCorpus ? &corpus : nullptr, begin, end);
+    int gridSize = useCorpus ? corpus.getGridSize() : options.gridSize;
+    int mines = useCorpus ? corpus.getMines() : options.mines;
+    std::uint64_t baseSeed = options.hasSeed ? options.baseSeed : std::random_device{}();
+
+    // One bit per solver per game, filled in by whichever worker played it
+    std::vector<std::uint32_t> outcomes(end - begin);
+    std::atomic<std::uint64_t> nextGame{begin};
+    std::mutex disagreementMutex;
+    std::map<std::uint64_t, boardCorpus::Layout> disagreements; // By game number
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; t++) {
+        workers.emplace_back([&]() {
+            std::uint64_t game = 0;
+            std::vector<Contestant> contestants(solverCount);
+            for (size_t s = 0; s < solverCount; s++) {
+                Board& board = *(contestants[s].board = std::make_unique<Board>(gridSize, mines));
+                loadNumberedGames(board, options, useCorpus ? &corpus : nullptr, baseSeed, game);
+                contestants[s].play = std::string(SOLVERS[s]) == "algo" ? playWith<algoSolver>(board, options)
+                                                                        : playWith<heatmapSolver>(board, options);
+            }
+
+            while ((game = nextGame.fetch_add(1)) < end) {
+                std::uint32_t won = 0;
+                for (size_t s = 0; s < solverCount; s++) won |= static_cast<std::uint32_t>(contestants[s].play()) << s;
+                outcomes[game - begin] = won;
+                if (won == 0 || won == (1u << solverCount) - 1) continue;
+
+                boardCorpus::Layout layout;
+                layout.seed = contestants[0].board->getSeed();
+                layout.startCell = useCorpus ? static_cast<int>(corpus.record(game).startCell) - 1 : -1;
+                contestants[0].board->getMineBits(layout.mineBits);
+                std::lock_guard<std::mutex> lock(disagreementMutex);
+                disagreements[game] = std::move(layout);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double elapsed = secondsSince(start);
+
+    std::uint64_t games = end - begin;
+    out << "Tournament: " << solverCount << " solvers, games " << begin << ".." << end << " ("
+        << (useCorpus ? "corpus " + options.corpusPath : "seeds " + std::to_string(baseSeed) + " + game") << ")\n";
+    for (size_t s = 0; s < solverCount; s++) {
+        std::uint64_t wins = 0;
+        for (std::uint32_t won : outcomes) wins += (won >> s) & 1;
+        winRateTest::Interval rate = winRateTest::wilson(wins, games);
+        out << "  " << SOLVERS[s] << ": " << wins << " wins, " << 100.0 * rate.centre << "% +- " << 100.0 * rate.halfWidth << "%\n";
+    }
+    for (size_t a = 0; a < solverCount; a++) {
+        for (size_t b = a + 1; b < solverCount; b++) {
+            winRateTest::Paired paired;
+            for (std::uint32_t won : outcomes) paired.add((won >> a) & 1, (won >> b) & 1);
+            winRateTest::Interval difference = paired.difference();
+            out << "  " << SOLVERS[a] << " vs " << SOLVERS[b] << ": both " << paired.both << ", only " << SOLVERS[a] << " "
+                << paired.onlyA << ", only " << SOLVERS[b] << " " << paired.onlyB << ", neither " << paired.neither
+                << "; difference " << 100.0 * difference.centre << "% +- " << 100.0 * difference.halfWidth << "%"
+                << (paired.significant(options.alpha) ? (paired.onlyA > paired.onlyB ? ", " + std::string(SOLVERS[a]) : ", " + std::string(SOLVERS[b])) + " is better" : "")
+                << "\n";
+        }
+    }
+
+    out << "Disagreements: " << disagreements.size() << " boards";
+    size_t shown = 0;
+    for (const auto& entry : disagreements) {
+        if (shown++ == SHOWN_DISAGREEMENTS) {
+            out << " ...";
+            break;
+        }
+        out << (shown == 1 ? ": game " : ", ") << entry.first;
+    }
+    out << "\n";
+    if (!options.disagreementsPath.empty()) {
+        std::vector<boardCorpus::Layout> layouts;
+        for (auto& entry : disagreements) layouts.push_back(std::move(entry.second));
+        if (!boardCorpus::write(options.disagreementsPath, gridSize, mines, layouts)) {
+            std::cerr << "Could not write corpus " << options.disagreementsPath << std::endl;
+            return 1;
+        }
+        out << "Wrote them in game order to " << options.disagreementsPath << "\n";
+    }
+    out << "Time: " << elapsed << "s (" << (elapsed > 0 ? games / elapsed : 0.0) << " games/s)" << std::endl;
+    return 0;
+}
+
+// heatmapSolver parameters --sweep can set, by name
+static const char* const SWEEP_PARAMS[] = {"infoBase", "infoGain", "unknownPenalty", "safeThreshold", "maxEmptyQueueAttempts"};
+
+static bool setSweepParam(heatmapSolver::Params& params, const std::string& name, double value) {
+    if (name == "infoBase") params.infoBase = static_cast<float>(value);
+    else if (name == "infoGain") params.infoGain = static_cast<float>(value);
+    else if (name == "unknownPenalty") params.unknownPenalty = static_cast<float>(value);
+    else if (name == "safeThreshold") params.safeThreshold = static_cast<float>(value);
+    else if (name == "maxEmptyQueueAttempts") params.maxEmptyQueueAttempts = static_cast<int>(std::lround(value));
+    else return false;
+    return true;
+}
+
+static std::string describeParams(const heatmapSolver::Params& params) {
+    std::ostringstream text;
+    text << "infoBase=" << params.infoBase << " infoGain=" << params.infoGain << " unknownPenalty=" << params.unknownPenalty
+         << " safeThreshold=" << params.safeThreshold << " maxEmptyQueueAttempts=" << params.maxEmptyQueueAttempts;
+    return text.str();
+}
+
+struct SweepAxis {
+    std::string name;
+    std::vector<double> values; // Grid points, or
+    double low = 0.0, high = 0.0; // a range to sample when values is empty
+};
+
+// Parses NAME=V1,V2,.. or NAME=LO:HI
+static bool parseSweepAxis(const std::string& spec, SweepAxis& axis) {
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos) return false;
+    axis.name = spec.substr(0, equals);
+    heatmapSolver::Params probe;
+    if (!setSweepParam(probe, axis.name, 0.0)) return false;
+    std::string values = spec.substr(equals + 1);
+    size_t colon = values.find(':');
+    if (colon != std::string::npos) {
+        axis.low = std::atof(values.substr(0, colon).c_str());
+        axis.high = std::atof(values.substr(colon + 1).c_str());
+        return axis.low <= axis.high;
+    }
+    std::istringstream list(values);
+    std::string value;
+    while (std::getline(list, value, ',')) axis.values.push_back(std::atof(value.c_str()));
+    return !axis.values.empty();
+}
+
+// Plays every parameter setting on the same games and ranks them by win rate
+static int runSweep(const HeadlessOptions& options, std::ostream& out) {
+    const int DEFAULT_SAMPLES = 20;
+
+    std::vector<SweepAxis> axes;
+    bool sampled = false;
+    for (const std::string& spec : options.sweep) {
+        SweepAxis axis;
+        if (!parseSweepAxis(spec, axis)) {
+            std::cerr << "Bad --sweep " << spec << " (NAME=V1,V2,.. or NAME=LO:HI with NAME one of";
+            for (const char* name : SWEEP_PARAMS) std::cerr << " " << name;
+            std::cerr << ")" << std::endl;
+            return 1;
+        }
+        sampled |= axis.values.empty();
+        axes.push_back(axis);
+    }
+
+    // Grid: every combination of the listed values. Random search: each axis drawn independently
+    std::uint64_t baseSeed = options.hasSeed ? options.baseSeed : std::random_device{}();
+    std::vector<heatmapSolver::Params> settings;
+    if (sampled) {
+        std::mt19937_64 rng(baseSeed);
+        int samples = options.sweepSamples > 0 ? options.sweepSamples : DEFAULT_SAMPLES;
+        for (int i = 0; i < samples; i++) {
+            heatmapSolver::Params params;
+            for (const SweepAxis& axis : axes) {
+                double value = axis.values.empty() ? std::uniform_real_distribution<double>(axis.low, axis.high)(rng)
+                                                   : axis.values[rng() % axis.values.size()];
+                setSweepParam(params, axis.name, value);
+            }
+            settings.push_back(params);
+        }
+    } else {
+        settings.emplace_back();
+        for (const SweepAxis& axis : axes) {
+            std::vector<heatmapSolver::Params> crossed;
+            for (const heatmapSolver::Params& params : settings) {
+                for (double value : axis.values) {
+                    crossed.push_back(params);
+                    setSweepParam(crossed.back(), axis.name, value);
+                }
+            }
+            settings.swap(crossed);
+        }
+    }
+
+    CorpusReader corpus;
+    bool useCorpus = !options.corpusPath.empty();
+    if (useCorpus && !corpus.open(options.corpusPath)) {
+        std::cerr << "Could not map corpus " << options.corpusPath << std::endl;
+        return 1;
+    }
+    std::uint64_t games = static_cast<std::uint64_t>(std::max(0, options.games));
+    if (useCorpus) games = options.hasGames ? std::min<std::uint64_t>(corpus.size(), games) : corpus.size();
+    int gridSize = useCorpus ? corpus.getGridSize() : options.gridSize;
+    int mines = useCorpus ? corpus.getMines() : options.mines;
+
+    // Jobs interleave the settings so each one's games are spread over every thread
+    std::uint64_t jobs = games * settings.size();
+    std::atomic<std::uint64_t> nextJob{0};
+    std::vector<std::atomic<std::uint64_t>> wins(settings.size());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; t++) {
+        workers.emplace_back([&]() {
+            const long long maxSteps = 16LL * gridSize * gridSize + 100;
+            std::uint64_t game = 0;
+            // Everything but the swept weights comes from the options, as in a plain run
+            Board board(gridSize, mines);
+            loadNumberedGames(board, options, useCorpus ? &corpus : nullptr, baseSeed, game);
+            heatmapSolver solver(board, nullptr);
+            configureSolver(solver, options);
+
+            for (std::uint64_t job; (job = nextJob.fetch_add(1)) < jobs;) {
+                size_t setting = job % settings.size();
+                game = job / settings.size();
+                solver.setParams(settings[setting]);
+                playGame(solver, board, maxSteps);
+                if (board.getGameState() == IBoardSolver::WON) wins[setting].fetch_add(1);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double elapsed = secondsSince(start);
+
+    std::vector<size_t> ranking(settings.size());
+    for (size_t i = 0; i < ranking.size(); i++) ranking[i] = i;
+    std::stable_sort(ranking.begin(), ranking.end(), [&](size_t a, size_t b) { return wins[a].load() > wins[b].load(); });
+
+    out << "Sweep: " << settings.size() << (sampled ? " random" : " grid") << " settings x " << games << " games ("
+        << (useCorpus ? "corpus " + options.corpusPath : "seeds " + std::to_string(baseSeed) + " +") << " 0.." << games << ")\n";
+    // Settings whose interval reaches the leader's can't be told apart from it on these games
+    double leaderLow = 0.0;
+    for (size_t rank = 0; rank < ranking.size(); rank++) {
+        winRateTest::Interval rate = winRateTest::wilson(wins[ranking[rank]].load(), games);
+        if (rank == 0) leaderLow = rate.centre - rate.halfWidth;
+        out << "  " << (rank + 1) << ". " << 100.0 * wins[ranking[rank]].load() / std::max<std::uint64_t>(1, games) << "% ["
+            << 100.0 * (rate.centre - rate.halfWidth) << "%, " << 100.0 * (rate.centre + rate.halfWidth) << "%]"
+            << (rate.centre + rate.halfWidth >= leaderLow ? " *" : "  ") << " " << describeParams(settings[ranking[rank]]) << "\n";
+    }
+    out << "(* = within the leader's 95% interval)\n";
+    out << "Time: " << elapsed << "s (" << (elapsed > 0 ? jobs / elapsed : 0.0) << " games/s)" << std::endl;
+    return 0;
+}
+
+// Brute-force mine probabilities of every unknown cell: each placement of the remaining
+// mines that agrees with the revealed numbers counts once
+static std::vector<double> enumerateProbabilities(const Board& board) {
+    int gridSize = board.getGridSize();
+    std::vector<int> unknowns;
+    int flags = 0;
+    for (int index = 0; index < gridSize * gridSize; index++) {
+        int view = board.getViewState(index % gridSize, index / gridSize);
+        if (view == -1) unknowns.push_back(index);
+        flags += view == -2;
+    }
+    int minesLeft = board.getTotalMines() - flags;
+    std::vector<double> probability(gridSize * gridSize, -1.0);
+    std::vector<std::uint64_t> hits(unknowns.size(), 0);
+    std::uint64_t layouts = 0;
+    std::vector<int> mine(gridSize * gridSize, 0);
+    for (std::uint64_t bits = 0; bits < (std::uint64_t(1) << unknowns.size()); bits++) {
+        if (__builtin_popcountll(bits) != minesLeft) continue;
+        for (size_t i = 0; i < unknowns.size(); i++) mine[unknowns[i]] = (bits >> i) & 1;
+        bool consistent = true;
+        for (int index = 0; consistent && index < gridSize * gridSize; index++) {
+            int x = index % gridSize, y = index / gridSize, view = board.getViewState(x, y);
+            if (view < 0) continue;
+            int around = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = x + dx, ny = y + dy;
+                    if ((dx || dy) && nx >= 0 && ny >= 0 && nx < gridSize && ny < gridSize) {
+                        int neighbor = ny * gridSize + nx;
+                        around += board.getViewState(nx, ny) == -2 || mine[neighbor];
+                    }
+                }
+            }
+            consistent = around == view;
+        }
+        if (!consistent) continue;
+        layouts++;
+        for (size_t i = 0; i < unknowns.size(); i++) hits[i] += (bits >> i) & 1;
+    }
+    for (size_t i = 0; i < unknowns.size(); i++) probability[unknowns[i]] = layouts ? static_cast<double>(hits[i]) / layouts : -1.0;
+    return probability;
+}
+
+// Quick checks of the statistics, the file formats and the exact analysis against hand-worked answers
+static int runSelfCheck(std::ostream& out) {
+    int failures = 0;
+    auto check = [&](bool ok, const std::string& what) {
+        out << (ok ? "  ok      " : "  FAILED  ") << what << "\n";
+        failures += !ok;
+    };
+    auto near = [](double a, double b) { return std::abs(a - b) < 1e-4; };
+
+    // Wilson interval: 50/100 is 0.5 +- 0.0962; it stays inside [0, 1] at the extremes
+    winRateTest::Interval half = winRateTest::wilson(50, 100);
+    check(near(half.centre, 0.5) && near(half.halfWidth, 0.09617), "Wilson interval of 50/100");
+    winRateTest::Interval none = winRateTest::wilson(0, 10), all = winRateTest::wilson(10, 10);
+    check(none.centre - none.halfWidth > -1e-12 && all.centre + all.halfWidth < 1.0 + 1e-12 && none.halfWidth > 0, "Wilson interval at 0/10 and 10/10");
+    check(winRateTest::wilson(0, 0).halfWidth == 1.0, "Wilson interval of no games");
+
+    // Paired test: 10 boards won only by A give a likelihood ratio of 2^10 / 11
+    winRateTest::Paired paired;
+    for (int i = 0; i < 10; i++) paired.add(true, false);
+    for (int i = 0; i < 90; i++) paired.add(i % 2 == 0, i % 2 == 0);
+    check(near(paired.logLikelihoodRatio(), std::log(1024.0 / 11.0)) && paired.significant(0.05) && !paired.significant(0.001),
+          "paired likelihood ratio of 10 one-sided boards");
+    check(near(paired.difference().centre, 0.1), "paired difference of 10 in 100");
+    winRateTest::Paired even;
+    for (int i = 0; i < 1000; i++) even.add(i % 2 == 0, i % 2 == 1);
+    check(!even.significant(0.05), "paired test on an even split");
+
+    // Sequential tally: once the test fires, later games change neither the counts nor the verdict
+    SequentialTally tally;
+    tally.versus = true;
+    for (int i = 0; i < 200 && !tally.stopped; i++) tally.add(i % 4 != 3, i % 4 == 3 && i % 8 == 7);
+    std::uint64_t counted = tally.games;
+    for (int i = 0; i < 500; i++) tally.add(false, true);
+    check(tally.stopped && tally.significant && tally.games == counted && tally.paired.games() == counted
+              && tally.paired.significant(tally.alpha) && tally.paired.onlyA > tally.paired.onlyB,
+          "sequential verdict frozen with its stop reason");
+    SequentialTally precise;
+    precise.precision = 0.05;
+    for (int i = 0; i < 10000 && !precise.stopped; i++) precise.add(i % 3 != 0, false);
+    check(precise.stopped && !precise.significant && winRateTest::wilson(precise.wins, precise.games).halfWidth <= 0.05,
+          "precision stop");
+
+    // GameStats and checkpoint text survive a write and a read
+    HeadlessOptions options;
+    options.baseSeed = 12345;
+    RunTotals totals;
+    totals.stats = std::make_unique<GameStats>(options.gridSize);
+    for (int game = 0; game < 5; game++) {
+        GameMetrics metrics;
+        metrics.won = game % 2 == 0;
+        metrics.moves = 10 + game;
+        metrics.guesses = game;
+        metrics.deductions[GameMetrics::SUBTRACTION] = 3 * game;
+        metrics.seconds = 0.001 * (game + 1);
+        metrics.threeBV = 7 + game;
+        metrics.missedSafeMoves = game / 2;
+        metrics.uncheckedGuesses = game / 3;
+        totals.stats->record(metrics);
+        totals.byThreeBV[metrics.threeBV] = {metrics.won ? 1 : 0, 1};
+    }
+    totals.wins = 3;
+    totals.losses = 2;
+    totals.abandoned = 1;
+    std::vector<GameRange> done = {{0, 256}, {512, 700}};
+    std::string key = checkpointKey(options, 0, 1000);
+    std::string text = checkpointText(key, options, totals, done);
+    char path[] = "/tmp/headless-check-XXXXXX";
+    int descriptor = mkstemp(path);
+    if (descriptor >= 0) close(descriptor);
+    HeadlessOptions resumed;
+    RunTotals loaded;
+    loaded.stats = std::make_unique<GameStats>(options.gridSize);
+    std::vector<GameRange> loadedDone;
+    bool read = descriptor >= 0 && writeCheckpoint(path, text) && readCheckpoint(path, key, false, resumed, loaded, loadedDone);
+    check(read && resumed.baseSeed == options.baseSeed && loadedDone == done
+              && checkpointText(key, resumed, loaded, loadedDone) == text,
+          "checkpoint round trip");
+    check(loaded.stats->getGames() == 5 && loaded.stats->getMissedSafeMoves() == totals.stats->getMissedSafeMoves(),
+          "GameStats state round trip");
+
+    // Replay log: varints of every width survive a write and a read
+    std::remove(path);
+    std::vector<std::uint8_t> encoded;
+    replayLog::appendVarint(encoded, 300);
+    check(encoded == std::vector<std::uint8_t>{0xAC, 0x02}, "varint encoding of 300");
+    const std::uint64_t seed = ~std::uint64_t(0) - 1;
+    const int moves[] = {0, 127, 128, 16383, 16384};
+    {
+        ReplayWriter writer;
+        writer.open(path);
+        writer.beginGame(seed, 200, 8000, true);
+        for (int move : moves) writer.recordMove(move, move % 2 ? IBoardSolver::FLAG : IBoardSolver::REVEAL);
+        writer.endGame(IBoardSolver::WON);
+    }
+    ReplayReader reader;
+    replayLog::GameRecord record;
+    bool replayed = reader.open(path) && reader.nextGame(record) && record.complete && record.seed == seed
+                    && record.gridSize == 200 && record.mines == 8000 && record.firstClickSafe
+                    && record.result == IBoardSolver::WON && record.moves.size() == std::size(moves);
+    for (size_t i = 0; replayed && i < record.moves.size(); i++) {
+        replayed = record.moves[i].cellIndex == moves[i]
+                   && record.moves[i].action == (moves[i] % 2 ? IBoardSolver::FLAG : IBoardSolver::REVEAL);
+    }
+    check(replayed && !reader.nextGame(record), "replay round trip");
+    std::remove(path);
+
+    // 3BV: mines in the four corners of a 3x3 board leave five isolated numbers and no opening;
+    // two opposite corners leave two openings that every number borders
+    Board board(3, 4);
+    std::uint64_t corners = (1u << 0) | (1u << 2) | (1u << 6) | (1u << 8);
+    board.loadLayout(0, &corners);
+    check(board.getThreeBV() == 5 && board.getDifficulty().openings == 0 && board.getDifficulty().isolatedNumbers == 5,
+          "3BV with four corner mines");
+    std::uint64_t diagonal = (1u << 0) | (1u << 8);
+    board.loadLayout(0, &diagonal);
+    check(board.getThreeBV() == 2 && board.getDifficulty().openings == 2 && board.getDifficulty().isolatedNumbers == 0,
+          "3BV with two corner mines");
+
+    // Exact analysis: two separate frontier components and the outside cells, tied only by
+    // the mine count, must match brute-force enumeration
+    Board split(5, 3);
+    std::uint64_t layout = (1u << 0) | (1u << 3) | (1u << 24);
+    split.loadLayout(0, &layout);
+    split.revealCell(1, 0); // With (2, 0), a component holding one mine or two
+    split.revealCell(2, 0);
+    split.revealCell(3, 4);
+    frontierAnalysis analysis;
+    BoardSnapshot snapshot(split);
+    bool exact = analysis.analyze(snapshot, frontierAnalysis::Clock::time_point::max());
+    std::vector<double> expected = enumerateProbabilities(split);
+    bool matches = exact && analysis.getComponents().size() >= 2;
+    for (int index = 0; matches && index < 25; index++) {
+        if (expected[index] >= 0) matches = near(analysis.getMineProbability(index), expected[index]);
+    }
+    check(matches, "frontier probabilities across " + std::to_string(analysis.getComponents().size()) + " components");
+
+    out << (failures ? std::to_string(failures) + " check(s) failed" : "All checks passed") << std::endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    // Keep the report on stdout but drop the per-move chatter unless asked for it
+    std::ostream out(std::cout.rdbuf());
+    if (!options.verbose) std::cout.setstate(std::ios::badbit);
+
+    if (options.selfCheck) {
+        return runSelfCheck(out);
+    }
+
+    if (!options.replayPath.empty()) {
+        return runReplay(options, out);
+    }
+
+    if (!options.generateCorpusPath.empty() && options.noGuess) {
+        return runNoGuessGeneration(options, out);
+    }
+
+    if (!options.generateCorpusPath.empty()) {
+        std::uint64_t baseSeed = options.hasSeed ? options.baseSeed : std::random_device{}();
+        auto start = std::chrono::steady_clock::now();
+        if (!boardCorpus::generate(options.generateCorpusPath, options.gridSize, options.mines, baseSeed, options.games)) {
+            std::cerr << "Could not write corpus " << options.generateCorpusPath << std::endl;
+            return 1;
+        }
+        double elapsed = secondsSince(start);
+        out << "Generated " << options.games << " boards (seeds " << baseSeed << "..) in " << elapsed << "s ("
+            << (elapsed > 0 ? options.games / elapsed : 0.0) << " boards/s)" << std::endl;
+        return 0;
+    }
+
+    if (options.tournament) {
+        return runTournament(options, out);
+    }
+
+    if (!options.sweep.empty()) {
+        return runSweep(options, out);
+    }
+
+    if (options.precision > 0 || !options.versusName.empty()) {
+        return runSequential(options, out);
+    }
+
+    return runSolvers(options, out);
+}
@@ -1,9 +1,15 @@
 #include "IBoardSolver.h"
 #include "Board.h"
 #include "solverUtilities.cpp"
+#include "guessSearch.cpp"
+#include "beliefPropagation.cpp"
+#include "constraintSolver.cpp"
+#include "gameRecorder.cpp"
+#include "GameStats.h"
 #include <queue>
 #include <set>
 #include <iostream>
+#include <chrono>
 #include <vector>
 #include <map>
 #include <cmath>
@@ -13,19 +19,37 @@ using namespace std;
 class BoardRenderer;
 
 class heatmapSolver {
+public:
+    // Tunable weights of the heuristic heatmap (used when no exact search decides the guess)
+    struct Params {
+        float infoBase = 0.5f;         // Weight of a number with no revealed neighbors
+        float infoGain = 1.5f;         // Added as all its neighbors get revealed
+        float unknownPenalty = 1.5f;   // Global density multiplier for cells no number touches
+        float safeThreshold = 0.001f;  // Below this a cell counts as safe, above it as informed
+        int maxEmptyQueueAttempts = 5; // Empty rounds before the solver gives up
+    };
+
 private:
+    Params params;
+
     IBoardSolver& gameBoard;
     BoardRenderer* renderer;
     bool firstMove = true;
-    sf::Clock moveClock;
+    std::chrono::steady_clock::time_point nextMoveTime; // When the next move is due
     float speed = 1.0f;
     float baseMoveDelay = 0.5f;
     bool waitingToClick = false;
     sf::Clock clickDelay;
     float preClickDelay = 0.2f;
     
+    bool turbo = false; // Batch/headless runs: no delay between moves
+    
     float getMoveDelay() const {
-        return baseMoveDelay / speed;
+        return turbo ? 0.0f : baseMoveDelay / speed;
+    }
+
+    void scheduleNextMove() {
+        solverUtilities::scheduleAfter(nextMoveTime, getMoveDelay());
     }
 
     queue<std::pair<int, int>> cellsToReveal;
@@ -39,14 +63,87 @@ private:
     int wins = 0;
     int losses = 0;
     bool gameWasCounted = false;
+    gameRecorder recorder;
     
     // Stuck detection
     int consecutiveEmptyQueues = 0;
-    const int MAX_EMPTY_QUEUE_ATTEMPTS = 5;
     
     // Safe start mode
     bool safeStartEnabled = false;
 
+    // Searches guesses instead of picking blindly when no certain move exists
+    guessSearch guesser;
+        
+    // Proves safe cells and mines incrementally, keeping what it learned between moves
+    constraintSolver prover;
+    
+    // Giant boards skip the per-move full-board scans and use belief propagation,
+    // which follows the board's change journal instead
+    static const int GIANT_BOARD_CELLS = 256 * 256;
+    static const int BELIEF_UPDATES_PER_MOVE = 20000;
+    static const int OUTSIDE_GUESS_TRIES = 64;
+    beliefPropagation belief;
+    
+    bool isGiantBoard() const {
+        int gridSize = gameBoard.getGridSize();
+        return gridSize * gridSize >= GIANT_BOARD_CELLS;
+    }
+    
+    // Heatmap display: exact or sampled probabilities, recomputed only when the view changes
+    static constexpr double DISPLAY_BUDGET_MS = 25.0;
+    probabilityEngine displayEngine;
+    map<pair<int, int>, float> displayHeatmap;
+    std::uint64_t displayHash = 0;
+    bool displayValid = false;
+    
+    const map<pair<int, int>, float>& refreshDisplayHeatmap() {
+        if (displayValid && displayHash == gameBoard.getViewHash()) return displayHeatmap;
+        displayHash = gameBoard.getViewHash();
+        displayValid = true;
+        
+        // The panel can't draw a giant board's cells, so don't build a map it would throw away
+        if (isGiantBoard()) {
+            displayHeatmap.clear();
+            if (renderer) renderer->setHeatmapCaption("Probability Heatmap");
+            return displayHeatmap;
+        }
+        
+        BoardSnapshot snapshot(gameBoard);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(DISPLAY_BUDGET_MS));
+        probabilityEngine::Method method = displayEngine.compute(snapshot, deadline);
+        string caption = "Probability Heatmap";
+        if (method == probabilityEngine::NONE) {
+            // Neither engine finished in budget: show the heuristic
+            displayHeatmap = calculateHeatmap();
+            caption += " (heuristic)";
+        } else {
+            displayHeatmap.clear();
+            int gridSize = snapshot.getGridSize();
+            for (int index = 0; index < gridSize * gridSize; index++) {
+                if (snapshot.isUnknown(index)) {
+                    displayHeatmap[{index % gridSize, index / gridSize}] = static_cast<float>(displayEngine.getMineProbability(index));
+                }
+            }
+            if (method == probabilityEngine::EXACT) {
+                caption += " (exact)";
+            } else {
+                int percent = static_cast<int>(std::ceil(displayEngine.getHalfWidth() * 100.0));
+                caption += " (sampled +/-" + to_string(percent) + "%)";
+                cout << "[Heatmap] Sampled " << displayEngine.getSampler().getSamples() << " layouts, 95% within +/-" << percent << "%" << endl;
+            }
+        }
+        if (renderer) renderer->setHeatmapCaption(caption);
+        return displayHeatmap;
+    }
+
+    // Queues the searched guess; false if the position was too big to search in budget
+    bool queueSearchedGuess() {
+        pair<int, int> move;
+        if (!recorder.searchGuess(guesser, "[Heatmap]", move, nextRevealIsGuess)) return false;
+        queueRevealCell(move);
+        return !cellsToReveal.empty();
+    }
+
     void queueRevealCell(pair<int, int> cell) {
         // Don't queue if already revealed
         if (gameBoard.searchCell(cell.first, cell.second)) {
@@ -68,7 +165,7 @@ private:
         }
         
         // Don't flag if we've already reached the maximum number of flags
-        const int totalMines = 10; // Standard minesweeper 9x9 grid has 10 mines
+        const int totalMines = gameBoard.getTotalMines();
         vector<pair<int, int>> currentlyFlagged = gameBoard.getAllFlaggedCells();
         if (currentlyFlagged.size() >= static_cast<size_t>(totalMines)) {
             cout << "[Heatmap] Already have " << currentlyFlagged.size() << " flags (max: " << totalMines << "). Not flagging more." << endl;
@@ -91,14 +188,16 @@ private:
         int oldX = gameBoard.getSelectedX();
         int oldY = gameBoard.getSelectedY();
         gameBoard.setSelectedCell(cell.first, cell.second);
-        renderer->startSelectionAnimation(oldX, oldY);
-        if (renderer && nextRevealIsGuess) {
-            renderer->setGuessMove(true);
+        if (renderer) renderer->startSelectionAnimation(oldX, oldY);
+        recorder.noteMove();
+        if (nextRevealIsGuess) {
+            recorder.noteGuess(cell.second * gameBoard.getGridSize() + cell.first);
+            if (renderer) renderer->setGuessMove(true);
             nextRevealIsGuess = false;
         }
-        renderer->startClickAnimation();
+        if (renderer) renderer->startClickAnimation();
         gameBoard.algoClick();
-        moveClock.restart();
+        scheduleNextMove();
         return;
     }
 
@@ -112,10 +211,11 @@ private:
         int oldX = gameBoard.getSelectedX();
         int oldY = gameBoard.getSelectedY();
         gameBoard.setSelectedCell(cell.first, cell.second);
-        renderer->startSelectionAnimation(oldX, oldY);
-        renderer->startClickAnimation();
+        if (renderer) renderer->startSelectionAnimation(oldX, oldY);
+        recorder.noteMove();
+        if (renderer) renderer->startClickAnimation();
         gameBoard.algoClick();
-        moveClock.restart();
+        scheduleNextMove();
         return;
     }
 
@@ -136,6 +236,7 @@ private:
     void randomGuessUntilZero() {
         vector<pair<int, int>> unrevealedCells = gameBoard.getAllUnrevealedCells();
         if (unrevealedCells.empty()) return;
+        if (queueSearchedGuess()) return;
         pair<int, int> move = solverUtilities::makeRandomMove(unrevealedCells);
         nextRevealIsGuess = true;
         queueRevealCell(move);
@@ -272,8 +373,8 @@ private:
             int revealedNeighborCount = actualNeighborCount - unrevealedCount - flaggedCount;
             
             // Information weight: more revealed neighbors = more reliable information
-            // Range from 0.5 (no revealed neighbors) to 2.0 (all neighbors revealed except unrevealed ones)
-            float infoWeight = 0.5f + (1.5f * static_cast<float>(revealedNeighborCount) / static_cast<float>(actualNeighborCount));
+            // Range from infoBase (no revealed neighbors) to infoBase + infoGain (all neighbors revealed except unrevealed ones)
+            float infoWeight = params.infoBase + (params.infoGain * static_cast<float>(revealedNeighborCount) / static_cast<float>(actualNeighborCount));
             
             // Apply weighted probability to each unrevealed neighbor
             float weightedProbability = baseProbability * infoWeight;
@@ -293,7 +394,7 @@ private:
         
         // For cells with no information, assign a default probability based on global mine density
         // This prevents them from being treated as "safest" when they actually have unknown risk
-        const int totalMines = 10;
+        const int totalMines = gameBoard.getTotalMines();
         vector<pair<int, int>> flaggedCells = gameBoard.getAllFlaggedCells();
         int remainingMines = totalMines - static_cast<int>(flaggedCells.size());
         int totalUnrevealedCells = static_cast<int>(unrevealedCells.size());
@@ -305,7 +406,7 @@ private:
             // Make it slightly higher to discourage random guessing
             for (const auto& cell : unrevealedCells) {
                 if (contributionCount[cell] == 0) {
-                    heatmap[cell] = globalMineDensity * 1.5f; // Penalize unknown cells
+                    heatmap[cell] = globalMineDensity * params.unknownPenalty; // Penalize unknown cells
                 }
             }
         }
@@ -334,7 +435,7 @@ private:
         
         // First, look for cells with 0 probability (definitely safe)
         for (const auto& entry : heatmap) {
-            if (entry.second < 0.001f) { // Essentially 0
+            if (entry.second < params.safeThreshold) { // Essentially 0
                 queueRevealCell(entry.first);
                 if (!cellsToReveal.empty()) return; // Queue one at a time
             }
@@ -343,6 +444,12 @@ private:
 
     // Find the cell with the lowest probability of being a mine
     void revealLowestProbabilityCell() {
+        // An exact search beats the heuristic whenever the position is small enough
+        if (queueSearchedGuess()) {
+            consecutiveEmptyQueues = 0;
+            return;
+        }
+        
         map<pair<int, int>, float> heatmap = calculateHeatmap();
         
         if (heatmap.empty()) return;
@@ -354,7 +461,7 @@ private:
         vector<pair<int, int>> cellsWithoutInfo;
         
         for (const auto& entry : heatmap) {
-            if (entry.second > 0.001f) { // Has information
+            if (entry.second > params.safeThreshold) { // Has information
                 cellsWithInfo.push_back(entry);
             } else { // No information
                 cellsWithoutInfo.push_back(entry.first);
@@ -372,11 +479,12 @@ private:
             }
             cout << "[Heatmap] Revealing cell with probability " << minCell.second << endl;
             queueRevealCell(minCell.first);
+            nextRevealIsGuess = !cellsToReveal.empty();
             
             // Check if the queue is still empty after attempting to queue
             if (cellsToReveal.empty() && cellsToFlag.empty()) {
                 consecutiveEmptyQueues++;
-                cout << "[Heatmap] Warning: No moves queued (" << consecutiveEmptyQueues << "/" << MAX_EMPTY_QUEUE_ATTEMPTS << ")" << endl;
+                cout << "[Heatmap] Warning: No moves queued (" << consecutiveEmptyQueues << "/" << params.maxEmptyQueueAttempts << ")" << endl;
                 
                 // Try to use subtraction logic to find safe cells before giving up
                 if (consecutiveEmptyQueues == 2) {
@@ -384,7 +492,7 @@ private:
                     applySubtractionLogic();
                 }
                 
-                if (consecutiveEmptyQueues >= MAX_EMPTY_QUEUE_ATTEMPTS) {
+                if (consecutiveEmptyQueues >= params.maxEmptyQueueAttempts) {
                     cout << "[Heatmap] Solver stuck - stopping. All remaining cells may be flagged or unreachable." << endl;
                     algoActive = false;
                     consecutiveEmptyQueues = 0;
@@ -417,18 +525,87 @@ private:
         }
     }
 
+    // Queue one cell the constraint solver can prove safe (or flag one it proves mined)
+    void queueProvenCell() {
+        prover.sync(gameBoard);
+        bool mine = false;
+        int cell = prover.findForcedCell(mine);
+        if (cell < 0) return;
+        int gridSize = gameBoard.getGridSize();
+        pair<int, int> position = {cell % gridSize, cell / gridSize};
+        if (mine) {
+            cout << "[Heatmap] Proven mine (" << position.first << ", " << position.second << ")" << endl;
+            queueFlagCell(position);
+        } else {
+            cout << "[Heatmap] Proven safe (" << position.first << ", " << position.second << ")" << endl;
+            queueRevealCell(position);
+        }
+    }
+
+    // Giant-board move: structural deductions first, then the lowest belief,
+    // guessing away from the frontier when the global density is lower
+    void processBelief() {
+        belief.sync(gameBoard);
+        belief.settle(BELIEF_UPDATES_PER_MOVE);
+        int gridSize = belief.getGridSize();
+        
+        for (int cell = belief.popForced(); cell >= 0; cell = belief.popForced()) {
+            pair<int, int> position = {cell % gridSize, cell / gridSize};
+            if (belief.isForcedSafe(cell)) {
+                cellsToReveal.push(position);
+                recorder.credit(GameMetrics::BELIEF);
+                return;
+            }
+            if (belief.getFlagCount() < gameBoard.getTotalMines() && queuedForFlagging.insert(position).second) {
+                cellsToFlag.push(position);
+                recorder.credit(GameMetrics::BELIEF);
+                return;
+            }
+        }
+        
+        int safest = -1;
+        for (int cell : belief.getFrontier()) {
+            if (safest < 0 || belief.getMineProbability(cell) < belief.getMineProbability(safest)) safest = cell;
+        }
+        
+        int guess = safest;
+        if (safest < 0 || belief.getOutsideProbability() < belief.getMineProbability(safest)) {
+            for (int attempt = 0; attempt < OUTSIDE_GUESS_TRIES; attempt++) {
+                int index = solverUtilities::getRandomInt(0, gridSize * gridSize - 1);
+                if (belief.isUnknown(index) && !belief.isFrontier(index)) {
+                    guess = index;
+                    break;
+                }
+            }
+        }
+        if (guess < 0) {
+            cout << "[Heatmap] No unrevealed cells available - stopping solver" << endl;
+            algoActive = false;
+            return;
+        }
+        cout << "[Heatmap] Belief guess (" << guess % gridSize << ", " << guess / gridSize << ") probability "
+             << belief.getMineProbability(guess) << endl;
+        nextRevealIsGuess = true;
+        cellsToReveal.push({guess % gridSize, guess / gridSize});
+    }
+
     void processHeatmap() {
         // First, use subtraction logic to find safe cells (like algo solver)
         if (cellsToReveal.empty() && cellsToFlag.empty()) {
-            applySubtractionLogic();
+            recorder.deduce(GameMetrics::SATISFIED_NUMBER, cellsToReveal, cellsToFlag, [this]() { applySubtractionLogic(); });
+        }
+        
+        // Second, cells the constraint solver can prove
+        if (cellsToReveal.empty() && cellsToFlag.empty()) {
+            recorder.deduce(GameMetrics::CONSTRAINT_PROOF, cellsToReveal, cellsToFlag, [this]() { queueProvenCell(); });
         }
         
-        // Second, find and reveal definitely safe cells from heatmap (probability = 0)
+        // Third, find and reveal definitely safe cells from heatmap (probability = 0)
         if (cellsToReveal.empty() && cellsToFlag.empty()) {
-            findSafeCells();
+            recorder.deduce(GameMetrics::ZERO_PROBABILITY, cellsToReveal, cellsToFlag, [this]() { findSafeCells(); });
         }
         
-        // Third, reveal the cell with lowest probability of being a mine
+        // Last, reveal the cell with lowest probability of being a mine
         if (cellsToReveal.empty() && cellsToFlag.empty()) {
             revealLowestProbabilityCell();
         }
@@ -436,16 +613,7 @@ private:
 
     void resetSolverState() {
         // Track game result before resetting
-        if (!gameWasCounted && gameBoard.isGameOver()) {
-            if (gameBoard.getGameState() == IBoardSolver::WON) {
-                wins++;
-                cout << "[Heatmap] Game Won! Total: " << wins << " wins, " << losses << " losses" << endl;
-            } else if (gameBoard.getGameState() == IBoardSolver::LOST) {
-                losses++;
-                cout << "[Heatmap] Game Lost! Total: " << wins << " wins, " << losses << " losses" << endl;
-            }
-            gameWasCounted = true;
-        }
+        countFinishedGame();
         
         // Preserve the active state so solver continues running after reset
         bool wasActive = algoActive;
@@ -467,10 +635,11 @@ private:
         gameWasCounted = false;
         nextRevealIsGuess = false;
         consecutiveEmptyQueues = 0; // Reset stuck detection
+        recorder.start();
     }
 
 public:
-    heatmapSolver(IBoardSolver& b, BoardRenderer* r) : gameBoard(b), renderer(r) {}
+    heatmapSolver(IBoardSolver& b, BoardRenderer* r) : gameBoard(b), renderer(r), recorder(b) {}
     
     void setSpeed(float newSpeed) {
         speed = std::max(0.1f, std::min(10.0f, newSpeed));
@@ -486,15 +655,62 @@ public:
     int getWins() const { return wins; }
     int getLosses() const { return losses; }
     int getTotalGames() const { return wins + losses; }
+    const GameStats& getStats() const { return recorder.getStats(); }
+    
+    // Counts a finished game once (wins/losses and its metrics); resets do this themselves
+    void countFinishedGame() {
+        if (gameWasCounted || !gameBoard.isGameOver()) return;
+        if (gameBoard.getGameState() == IBoardSolver::WON) {
+            wins++;
+            cout << "[Heatmap] Game Won! Total: " << wins << " wins, " << losses << " losses" << endl;
+        } else if (gameBoard.getGameState() == IBoardSolver::LOST) {
+            losses++;
+            cout << "[Heatmap] Game Lost! Total: " << wins << " wins, " << losses << " losses" << endl;
+        }
+        recorder.finish();
+        gameWasCounted = true;
+    }
     
     void setSafeStart(bool enabled) {
         safeStartEnabled = enabled;
     }
     
+    void setTurbo(bool enabled) {
+        turbo = enabled;
+    }
+    
+    // Per-guess search budget in milliseconds, 0 turns the search off
+    void setGuessBudget(double milliseconds) {
+        guesser.setBudget(milliseconds);
+    }
+    
+    // Threads the guess search may use for sampling and scoring (defaults to every core)
+    void setGuessThreads(int count) {
+        guesser.setThreads(count);
+    }
+    
+    // Counts guesses made while a provably safe cell existed (costs an exact analysis per guess)
+    void setOracle(bool enabled) {
+        recorder.setOracle(enabled);
+    }
+    
+    void setParams(const Params& newParams) {
+        params = newParams;
+        params.maxEmptyQueueAttempts = std::max(1, params.maxEmptyQueueAttempts);
+    }
+    
+    const Params& getParams() const { return params; }
+    
+    // Abandon the current game (if any) and start a fresh one, keeping the solver running
+    void restartGame() {
+        resetSolverState();
+        algoActive = true;
+    }
+    
     // Get current heatmap for visualization
-    map<pair<int, int>, float> getHeatmapData() const {
-        // Always return heatmap data, even during random guess phase
-        return const_cast<heatmapSolver*>(this)->calculateHeatmap();
+    // Recomputed only when the board view changed; always returned, even during the random guess phase
+    const map<pair<int, int>, float>& getHeatmapData() {
+        return refreshDisplayHeatmap();
     }
     
     void start() {
@@ -511,10 +727,19 @@ public:
     bool isActive() const {
         return algoActive;
     }
+    
+    // True while makeMove() still has something to do (playing, or a finished game to reset)
+    bool hasPendingWork() const {
+        return algoActive || gameBoard.isGameOver();
+    }
+    
+    std::chrono::steady_clock::time_point getNextMoveTime() const {
+        return nextMoveTime;
+    }
 
     void makeMove() {
         // Only make a move if enough time has passed
-        if (moveClock.getElapsedTime().asSeconds() < getMoveDelay()) {
+        if (std::chrono::steady_clock::now() < nextMoveTime) {
             return;
         }
 
@@ -538,7 +763,11 @@ public:
         // Both queues are empty, check what phase we're in
         if (renderer) renderer->stopInspection();
         
-        if (inRandomGuessPhase) {
+        if (isGiantBoard()) {
+            processBelief();
+            preformNextAction();
+            scheduleNextMove();
+        } else if (inRandomGuessPhase) {
             // Check if we have any 0 cells
             bool hasZeroCells = false;
             int gridSize = gameBoard.getGridSize();
@@ -559,14 +788,14 @@ public:
                 processHeatmap();
                 
                 if (preformNextAction()) {
-                    moveClock.restart();
+                    scheduleNextMove();
                     return;
                 }
                 
                 // If no logical moves, processHeatmap will still queue the lowest probability cell
                 cout << "[Heatmap] No definite moves, making educated guess." << endl;
                 if (preformNextAction()) {
-                    moveClock.restart();
+                    scheduleNextMove();
                     return;
                 }
             }
@@ -574,13 +803,13 @@ public:
             // Still in random guess phase
             randomGuessUntilZero();
             preformNextAction();
-            moveClock.restart();
+            scheduleNextMove();
         } else {
             // We're in heatmap analysis phase
             processHeatmap();
             
             if (preformNextAction()) {
-                moveClock.restart();
+                scheduleNextMove();
                 return;
             }
             
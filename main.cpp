@@ -1,27 +1,83 @@
 #include <SFML/Graphics.hpp>
 #include "Board.h"
 #include "BoardRenderer.h"
+#include "FramePacer.h"
+#include "ReplayLog.h"
+#include "BoardPool.h"
 #include <iostream>
 #include <optional>
+#include <random>
+#include <string>
+#include <vector>
 #include <cstdlib>
 #include <ctime>
+#include <algorithm>
 #include "algoSolver.cpp"
 #include "heatmapSolver.cpp"
 
 enum SolverType { ALGO_SOLVER, HEATMAP_SOLVER, MANUAL_PLAYER };
 
-int main() {    
+int main(int argc, char* argv[]) {    
     // Seed random number generator for different results each run
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    solverUtilities::seed(static_cast<std::uint64_t>(std::time(nullptr)));
+    
+    // Usage: ./m [gridSize] [mines] [--record FILE | --no-record] [--replay FILE] [--fps N (0 = uncapped)]
+    std::string recordPath = "games.mreplay";
+    std::string replayPath;
+    unsigned int fpsCap = FramePacer::DEFAULT_FPS_CAP;
+    std::vector<int> positionalArgs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--no-record") recordPath.clear();
+        else if (arg == "--replay" && i + 1 < argc) replayPath = argv[++i];
+        else if (arg == "--fps" && i + 1 < argc) fpsCap = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+        else positionalArgs.push_back(std::atoi(argv[i]));
+    }
+    
+    // Optional board size and mine count (mines default to the standard 9x9 density)
+    int gridSize = Board::DEFAULT_GRID_SIZE;
+    int mineCount = Board::DEFAULT_MINES;
+    if (positionalArgs.size() > 0) gridSize = std::max(2, positionalArgs[0]);
+    if (positionalArgs.size() > 1) mineCount = positionalArgs[1];
+    else if (positionalArgs.size() > 0) mineCount = gridSize * gridSize * Board::DEFAULT_MINES / (Board::DEFAULT_GRID_SIZE * Board::DEFAULT_GRID_SIZE);
+    mineCount = std::clamp(mineCount, 1, gridSize * gridSize - 1);
     
     // Create the main window with initial size (board + mode indicator + side panel + heatmap)
     sf::RenderWindow window(sf::VideoMode({670, 830}), "Minesweeper");
     
-    Board board;
+    Board board(gridSize, mineCount);
     BoardRenderer renderer(board, window);
+    FramePacer framePacer(window);
+    framePacer.setFpsCap(fpsCap);
     algoSolver algoSolverInstance(board, &renderer);
     heatmapSolver heatmapSolverInstance(board, &renderer);
     
+    // Replay playback (--replay) or recording of every game played (default)
+    ReplayPlayer replayPlayer(board);
+    ReplayWriter replayWriter;
+    bool replayMode = !replayPath.empty();
+    if (replayMode) {
+        if (!replayPlayer.open(replayPath) || !replayPlayer.loadNextGame()) {
+            std::cout << "Could not read replay log " << replayPath << std::endl;
+            return 1;
+        }
+        std::cout << "Replaying " << replayPath << " (N = next game, +/- = playback speed)" << std::endl;
+    } else if (!recordPath.empty()) {
+        if (replayWriter.open(recordPath)) {
+            board.setRecorder(&replayWriter);
+        } else {
+            std::cout << "Could not open replay log " << recordPath << ", recording disabled" << std::endl;
+        }
+    }
+
+    // New games come from boards generated ahead on a background thread (replays pick their own)
+    std::optional<BoardPool> boardPool;
+    if (!replayMode) {
+        boardPool.emplace(gridSize, mineCount, board.isFirstClickSafe(), std::mt19937_64(std::random_device{}()));
+        boardPool->attach(board);
+    }
+    
     // Current solver selection (default to manual player)
     SolverType currentSolver = MANUAL_PLAYER;
     
@@ -34,8 +90,21 @@ int main() {
 
     // Game loop
     while (window.isOpen()) {
+        // Work out whether the next frame can wait: only an animation or a scheduled solver move needs one
+        std::optional<FramePacer::TimePoint> solverWakeAt;
+        if (currentSolver == ALGO_SOLVER && algoSolverInstance.hasPendingWork()) {
+            solverWakeAt = algoSolverInstance.getNextMoveTime();
+        } else if (currentSolver == HEATMAP_SOLVER && heatmapSolverInstance.hasPendingWork()) {
+            solverWakeAt = heatmapSolverInstance.getNextMoveTime();
+        }
+        if (replayMode) {
+            std::optional<FramePacer::TimePoint> replayWakeAt = replayPlayer.getNextMoveTime();
+            if (replayWakeAt && (!solverWakeAt || *replayWakeAt < *solverWakeAt)) solverWakeAt = replayWakeAt;
+        }
+        std::optional<sf::Event> firstEvent = framePacer.waitForEvent(renderer.isAnimating(), solverWakeAt);
+        
         // Process events
-        while (const std::optional event = window.pollEvent()) {
+        for (std::optional event = firstEvent ? firstEvent : window.pollEvent(); event; event = window.pollEvent()) {
             // Handle input events
             if (!event) continue;
 
@@ -105,13 +174,43 @@ int main() {
                     heatmapSolverInstance.setSafeStart(safeStartEnabled);
                     std::cout << "Safe start " << (safeStartEnabled ? "enabled" : "disabled") << std::endl;
                 }
+
+                // C: place mines on the first reveal instead of up front (from the next game)
+                if (keyEvent && !replayMode && keyEvent->code == sf::Keyboard::Key::C) {
+                    board.setFirstClickSafe(!board.isFirstClickSafe());
+                    // Pooled games were prepared for the old mode, so start a pool for the new one
+                    boardPool.reset();
+                    boardPool.emplace(gridSize, mineCount, board.isFirstClickSafe(), std::mt19937_64(std::random_device{}()));
+                    boardPool->attach(board);
+                    std::cout << "First click safe " << (board.isFirstClickSafe() ? "enabled" : "disabled") << " from the next game" << std::endl;
+                }
                 
                 if (keyEvent && keyEvent->code == sf::Keyboard::Key::F) {
                     renderer.setDebugOverlay(true);
                 }
                 
+                // V toggles vsync; otherwise frames are capped at the FPS limit
+                if (keyEvent && keyEvent->code == sf::Keyboard::Key::V) {
+                    framePacer.setVsync(!framePacer.isVsyncEnabled());
+                    std::cout << "Vsync " << (framePacer.isVsyncEnabled() ? "enabled" : "disabled") << std::endl;
+                }
+                
+                // Replay: N jumps to the next recorded game
+                if (keyEvent && replayMode && keyEvent->code == sf::Keyboard::Key::N) {
+                    if (replayPlayer.loadNextGame()) {
+                        std::cout << "Replaying game " << replayPlayer.getGameNumber() << " (seed " << replayPlayer.getCurrentGame().seed << ")" << std::endl;
+                    } else {
+                        std::cout << "End of replay log" << std::endl;
+                    }
+                }
+                
                 // Speed controls: + or = to increase, - to decrease
-                if (keyEvent && (keyEvent->code == sf::Keyboard::Key::Equal || keyEvent->code == sf::Keyboard::Key::Hyphen)) {
+                if (keyEvent && replayMode && currentSolver == MANUAL_PLAYER && (keyEvent->code == sf::Keyboard::Key::Equal || keyEvent->code == sf::Keyboard::Key::Hyphen)) {
+                    // Replay playback rate doubles/halves
+                    double rate = replayPlayer.getMovesPerSecond();
+                    replayPlayer.setMovesPerSecond(keyEvent->code == sf::Keyboard::Key::Equal ? rate * 2 : rate / 2);
+                    std::cout << "Replay speed " << replayPlayer.getMovesPerSecond() << " moves/s" << std::endl;
+                } else if (keyEvent && (keyEvent->code == sf::Keyboard::Key::Equal || keyEvent->code == sf::Keyboard::Key::Hyphen)) {
                     if (currentSolver == ALGO_SOLVER) {
                         float currentSpeed = algoSolverInstance.getSpeed();
                         if (keyEvent->code == sf::Keyboard::Key::Equal) {
@@ -205,34 +304,46 @@ int main() {
                             }
                         }
                     } else {
-                        // Regular board click - check bounds
-                        int x = mouseEvent->position.x / static_cast<int>(renderer.getCellSize());
-                        int y = mouseEvent->position.y / static_cast<int>(renderer.getCellSize());
+                        // Regular board click - map through the (possibly zoomed) board view
+                        int x = 0;
+                        int y = 0;
                         
                         // Only handle click if within board boundaries
-                        if (x >= 0 && x < board.getGridSize() && y >= 0 && y < board.getGridSize()) {
+                        if (renderer.pixelToCell(mouseEvent->position.x, mouseEvent->position.y, x, y)) {
                             board.handleClick(x, y);
                             renderer.startClickAnimation();
                         }
                     }
                 }
             }
+            
+            // Mouse wheel zooms the board view around the cursor
+            if (event->is<sf::Event::MouseWheelScrolled>()) {
+                const auto& wheelEvent = event->getIf<sf::Event::MouseWheelScrolled>();
+                if (wheelEvent && wheelEvent->wheel == sf::Mouse::Wheel::Vertical) {
+                    renderer.zoomAt(wheelEvent->position.x, wheelEvent->position.y, wheelEvent->delta);
+                }
+            }
         }
 
         // Render
         renderer.render();
         
         // Always get heatmap data for visualization (looks cool!)
-        auto heatmapData = heatmapSolverInstance.getHeatmapData();
+        const auto& heatmapData = heatmapSolverInstance.getHeatmapData();
         
         // Display stats for current solver
         if (currentSolver == ALGO_SOLVER) {
             renderer.drawStatsAndControls(algoSolverInstance.getWins(), algoSolverInstance.getLosses(), 
                                          algoSolverInstance.getSpeed(), "Algo", algoSolverInstance.isActive(),
-                                         &heatmapData, safeStartEnabled);
+                                         &heatmapData, safeStartEnabled, &algoSolverInstance.getStats());
         } else if (currentSolver == HEATMAP_SOLVER) {
             renderer.drawStatsAndControls(heatmapSolverInstance.getWins(), heatmapSolverInstance.getLosses(), 
                                          heatmapSolverInstance.getSpeed(), "Heatmap", heatmapSolverInstance.isActive(),
+                                         &heatmapData, safeStartEnabled, &heatmapSolverInstance.getStats());
+        } else if (replayMode) {
+            // Replay playback - speed shows moves per second
+            renderer.drawStatsAndControls(0, 0, static_cast<float>(replayPlayer.getMovesPerSecond()), "Replay", !replayPlayer.isGameFinished(),
                                          &heatmapData, safeStartEnabled);
         } else {
             // Manual player mode - no wins/losses tracked, speed N/A, never "active"
@@ -250,5 +361,15 @@ int main() {
         }
         // Manual player mode: user controls all moves via mouse/keyboard
         
+        // Replay playback applies every recorded move that has fallen due
+        if (replayMode) {
+            int oldX = board.getSelectedX();
+            int oldY = board.getSelectedY();
+            if (replayPlayer.advance() > 0) {
+                renderer.startSelectionAnimation(oldX, oldY);
+                renderer.startClickAnimation();
+            }
+        }
+        
     }
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+#ifndef MINE_SAMPLER_H
+#define MINE_SAMPLER_H
+
+#include "BoardSnapshot.h"
+#include "workerPool.cpp"
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+
+/**
+ * Monte Carlo estimate of per-cell mine probabilities for positions too big to enumerate.
+ *
+ * Each thread runs its own Markov chain over frontier assignments. Numbers are soft
+ * constraints (energy = total mismatch, weight exp(-BETA * energy)) so the chain can
+ * pass through inconsistent states, and only consistent states are recorded. The
+ * global mine count enters as C(outside cells, mines left for them), which makes
+ * the recorded samples exactly the posterior over consistent layouts.
+ * Confidence is the 95% half-width of batch means across all chains.
+ */
+class mineSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double BETA = 2.5;            // Penalty per unit of constraint mismatch
+    static constexpr double TARGET_HALF_WIDTH = 0.01;
+    static const int BATCHES_PER_CHAIN = 4;
+    static const int SWEEPS_PER_BLOCK = 256;      // Consecutive sweeps recorded into the same batch
+
+private:
+    struct Model {
+        std::vector<int> cells;                       // Frontier cell indices
+        std::vector<std::vector<int>> cellConstraints;
+        std::vector<std::vector<int>> constraintCells;
+        std::vector<int> need;
+        int outside = 0;
+        int minesLeft = 0;
+    };
+
+    // One Markov chain; persists across sampling rounds
+    struct Chain {
+        std::mt19937_64 rng;
+        std::vector<std::uint8_t> mine;
+        std::vector<int> count;       // Mines currently placed around each number
+        int frontierMines = 0;
+        int energy = 0;
+        long long sweeps = 0;
+
+        // Recorded samples, in batches of consecutive sweeps for the confidence estimate
+        std::vector<std::vector<double>> batchMines;
+        std::vector<double> batchOutside;
+        std::vector<long long> batchSamples;
+    };
+
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::unique_ptr<workerPool> pool; // Started on the first parallel sampling round
+    std::vector<double> probability;
+    double halfWidth = 1.0;
+    long long samples = 0;
+
+public:
+    void setThreads(int count) {
+        threads = std::max(1, count);
+        if (pool && pool->getThreads() != threads) pool.reset();
+    }
+
+    // Samples until the deadline or until every estimate is within TARGET_HALF_WIDTH;
+    // false if no consistent layout was found
+    bool sample(const BoardSnapshot& snapshot, Clock::time_point deadline, std::uint64_t seed = 0) {
+        Model model = buildModel(snapshot);
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        probability.assign(cellCount, -1.0);
+        samples = 0;
+        halfWidth = 1.0;
+        if (model.minesLeft < 0 || model.minesLeft > model.outside + static_cast<int>(model.cells.size())) return false;
+
+        std::vector<Chain> chains(threads);
+        for (int t = 0; t < threads; t++) initChain(model, seed * 0x9E3779B97F4A7C15ULL + t + 1, chains[t]);
+
+        // Sample in rounds of growing length until confident or out of time
+        auto roundLength = std::chrono::milliseconds(2);
+        while (true) {
+            Clock::time_point roundEnd = std::min(deadline, Clock::now() + roundLength);
+            if (threads > 1) {
+                if (!pool) pool = std::make_unique<workerPool>(threads - 1);
+                pool->run(threads, [&](int t) { runChain(model, roundEnd, chains[t]); });
+            } else {
+                runChain(model, roundEnd, chains[0]);
+            }
+
+            if (!summarize(snapshot, model, chains)) {
+                if (Clock::now() >= deadline) return false;
+            } else if (halfWidth <= TARGET_HALF_WIDTH || Clock::now() >= deadline) {
+                return true;
+            }
+            roundLength *= 2;
+        }
+    }
+
+    double getMineProbability(int index) const { return probability[index]; }
+    const std::vector<double>& getProbabilities() const { return probability; }
+    double getHalfWidth() const { return halfWidth; } // 95% confidence, worst cell
+    long long getSamples() const { return samples; }
+
+private:
+    bool summarize(const BoardSnapshot& snapshot, const Model& model, const std::vector<Chain>& chains) {
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        samples = 0;
+        halfWidth = 1.0;
+
+        // Pool batch means across chains
+        int frontierSize = static_cast<int>(model.cells.size());
+        std::vector<double> mineTotals(frontierSize, 0.0);
+        double outsideTotal = 0.0;
+        std::vector<std::vector<double>> batchMeans;
+        std::vector<double> batchOutsideMeans;
+        for (const Chain& chain : chains) {
+            for (int b = 0; b < BATCHES_PER_CHAIN; b++) {
+                long long count = chain.batchSamples[b];
+                if (count == 0) continue;
+                samples += count;
+                outsideTotal += chain.batchOutside[b];
+                std::vector<double> means(frontierSize);
+                for (int i = 0; i < frontierSize; i++) {
+                    mineTotals[i] += chain.batchMines[b][i];
+                    means[i] = chain.batchMines[b][i] / count;
+                }
+                batchMeans.push_back(std::move(means));
+                batchOutsideMeans.push_back(chain.batchOutside[b] / count);
+            }
+        }
+        if (samples == 0) return false;
+
+        probability.assign(cellCount, -1.0);
+        for (int i = 0; i < frontierSize; i++) probability[model.cells[i]] = mineTotals[i] / samples;
+        double outsideProbability = outsideTotal / samples;
+        for (int index = 0; index < cellCount; index++) {
+            if (snapshot.isUnknown(index) && probability[index] < 0.0) probability[index] = outsideProbability;
+        }
+
+        size_t batches = batchMeans.size();
+        if (frontierSize == 0) {
+            halfWidth = 0.0; // Only the outside density, which is exact
+        } else if (batches >= 2) {
+            double worst = spreadOf(batchOutsideMeans, outsideProbability);
+            for (int i = 0; i < frontierSize; i++) {
+                std::vector<double> column(batches);
+                for (size_t b = 0; b < batches; b++) column[b] = batchMeans[b][i];
+                worst = std::max(worst, spreadOf(column, probability[model.cells[i]]));
+            }
+            halfWidth = 1.96 * worst / std::sqrt(static_cast<double>(batches));
+        }
+        return true;
+    }
+
+    static double spreadOf(const std::vector<double>& values, double mean) {
+        double sum = 0.0;
+        for (double value : values) sum += (value - mean) * (value - mean);
+        return std::sqrt(sum / (values.size() - 1));
+    }
+
+    static Model buildModel(const BoardSnapshot& snapshot) {
+        Model model;
+        std::vector<BoardSnapshot::FrontierComponent> frontier = snapshot.getFrontierComponents();
+        std::vector<int> position(snapshot.getGridSize() * snapshot.getGridSize(), -1);
+        for (const auto& component : frontier) {
+            for (int cell : component.unknowns) {
+                position[cell] = static_cast<int>(model.cells.size());
+                model.cells.push_back(cell);
+            }
+        }
+        model.cellConstraints.resize(model.cells.size());
+
+        int neighbors[8];
+        for (const auto& component : frontier) {
+            for (int number : component.numbers) {
+                int constraint = static_cast<int>(model.need.size());
+                int need = snapshot.get(number);
+                std::vector<int> members;
+                int count = snapshot.getNeighbors(number, neighbors);
+                for (int i = 0; i < count; i++) {
+                    int value = snapshot.get(neighbors[i]);
+                    if (value == BoardSnapshot::FLAGGED) need--;
+                    if (value != BoardSnapshot::UNKNOWN) continue;
+                    members.push_back(position[neighbors[i]]);
+                    model.cellConstraints[position[neighbors[i]]].push_back(constraint);
+                }
+                model.need.push_back(need);
+                model.constraintCells.push_back(std::move(members));
+            }
+        }
+        model.outside = snapshot.getUnknownCount() - static_cast<int>(model.cells.size());
+        model.minesLeft = snapshot.getTotalMines() - snapshot.getFlagCount();
+        return model;
+    }
+
+    static void initChain(const Model& model, std::uint64_t seed, Chain& chain) {
+        int size = static_cast<int>(model.cells.size());
+        chain.rng.seed(seed);
+        chain.mine.assign(size, 0);
+        chain.count.assign(model.need.size(), 0);
+        chain.frontierMines = 0;
+        chain.energy = 0;
+        for (int need : model.need) chain.energy += std::abs(need);
+        chain.batchMines.assign(BATCHES_PER_CHAIN, std::vector<double>(size, 0.0));
+        chain.batchOutside.assign(BATCHES_PER_CHAIN, 0.0);
+        chain.batchSamples.assign(BATCHES_PER_CHAIN, 0);
+
+        // Start with enough frontier mines that the outside can take the rest
+        while (!outsideAllows(model, chain.frontierMines) && chain.frontierMines < size) {
+            int cell = static_cast<int>(chain.rng() % size);
+            if (chain.mine[cell]) continue;
+            chain.energy += mismatchDelta(model, chain, cell, 1);
+            apply(model, chain, cell, 1);
+        }
+    }
+
+    // A frontier mine count k leaves minesLeft - k for the outside cells
+    static bool outsideAllows(const Model& model, int k) {
+        return k <= model.minesLeft && model.minesLeft - k <= model.outside;
+    }
+
+    static int mismatchDelta(const Model& model, const Chain& chain, int cell, int delta) {
+        int change = 0;
+        for (int c : model.cellConstraints[cell]) {
+            change += std::abs(chain.count[c] + delta - model.need[c]) - std::abs(chain.count[c] - model.need[c]);
+        }
+        return change;
+    }
+
+    static void apply(const Model& model, Chain& chain, int cell, int delta) {
+        for (int c : model.cellConstraints[cell]) chain.count[c] += delta;
+        chain.mine[cell] = static_cast<std::uint8_t>(chain.mine[cell] + delta);
+        chain.frontierMines += delta;
+    }
+
+    static void runChain(const Model& model, Clock::time_point until, Chain& chain) {
+        int size = static_cast<int>(model.cells.size());
+        std::mt19937_64& rng = chain.rng;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        while (true) {
+            for (int step = 0; step < size; step++) {
+                int cell = static_cast<int>(rng() % size);
+                if (rng() & 1) {
+                    // Flip: trades a mine with the outside cells
+                    int delta = chain.mine[cell] ? -1 : 1;
+                    if (!outsideAllows(model, chain.frontierMines + delta)) continue;
+                    int outsideMines = model.minesLeft - chain.frontierMines;
+                    double ratio = delta > 0
+                        ? static_cast<double>(outsideMines) / (model.outside - outsideMines + 1)
+                        : static_cast<double>(model.outside - outsideMines) / (outsideMines + 1);
+                    int change = mismatchDelta(model, chain, cell, delta);
+                    if (unit(rng) < ratio * std::exp(-BETA * change)) {
+                        chain.energy += change;
+                        apply(model, chain, cell, delta);
+                    }
+                } else {
+                    // Swap with a cell sharing one of its numbers: keeps the mine count
+                    const std::vector<int>& constraints = model.cellConstraints[cell];
+                    const std::vector<int>& partners = model.constraintCells[constraints[rng() % constraints.size()]];
+                    int other = partners[rng() % partners.size()];
+                    if (chain.mine[other] == chain.mine[cell]) continue;
+                    int from = chain.mine[cell] ? cell : other;
+                    int to = chain.mine[cell] ? other : cell;
+                    int change = mismatchDelta(model, chain, from, -1);
+                    apply(model, chain, from, -1);
+                    change += mismatchDelta(model, chain, to, 1);
+                    apply(model, chain, to, 1);
+                    if (unit(rng) < std::exp(-BETA * change)) {
+                        chain.energy += change;
+                    } else {
+                        apply(model, chain, to, -1);
+                        apply(model, chain, from, 1);
+                    }
+                }
+            }
+
+            chain.sweeps++;
+            if (chain.energy == 0 && outsideAllows(model, chain.frontierMines)) {
+                int batch = static_cast<int>((chain.sweeps / SWEEPS_PER_BLOCK) % BATCHES_PER_CHAIN);
+                std::vector<double>& totals = chain.batchMines[batch];
+                for (int i = 0; i < size; i++) totals[i] += chain.mine[i];
+                if (model.outside > 0) chain.batchOutside[batch] += static_cast<double>(model.minesLeft - chain.frontierMines) / model.outside;
+                chain.batchSamples[batch]++;
+            }
+            if (size == 0 || ((chain.sweeps & 63) == 0 && Clock::now() > until)) break;
+        }
+    }
+};
+
+#endif
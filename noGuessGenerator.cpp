@@ -0,0 +1,206 @@
+#ifndef NO_GUESS_GENERATOR_H
+#define NO_GUESS_GENERATOR_H
+
+#include "Board.h"
+#include "BoardSnapshot.h"
+#include "BoardCorpus.h"
+#include "frontierAnalysis.cpp"
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * Finds seeds whose boards can be cleared by deduction alone, for benchmarking
+ * pure deduction speed.
+ *
+ * Each candidate is the seed's ordinary layout opened at a zero of its largest
+ * opening. The check plays it out on a snapshot: single-number rules first, the
+ * exact frontier analysis (global mine count included) only when those stall.
+ * A board is rejected as soon as neither finds a certain cell. Rejected boards
+ * are not repaired, so every accepted board is still reproduced by its seed
+ * (replays and corpus records stay valid).
+ *
+ * Workers pull seeds from a shared counter; the accepted boards with the lowest
+ * seeds are kept, so the output doesn't depend on the thread count. At densities
+ * where no-guess boards are (nearly) impossible the search gives up after a fixed
+ * number of candidates and returns the boards it found.
+ */
+class noGuessGenerator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Verdict { SOLVABLE, NO_OPENING, NEEDS_GUESS, TOO_HARD };
+
+    static constexpr std::uint64_t CANDIDATES_PER_BOARD = 1000; // Gives up below a 0.1% acceptance rate
+    static constexpr std::uint64_t MIN_CANDIDATES = 100000; // But tries at least this many
+
+    struct Stats {
+        std::uint64_t candidates = 0;
+        std::uint64_t accepted = 0;
+        std::uint64_t noOpening = 0;
+        std::uint64_t needsGuess = 0;
+        std::uint64_t tooHard = 0;
+        bool gaveUp = false; // Hit the candidate limit before finding every board
+        double seconds = 0.0;
+
+        double boardsPerSecond() const { return seconds > 0.0 ? accepted / seconds : 0.0; }
+    };
+
+private:
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    Stats stats;
+
+public:
+    void setThreads(int count) { threads = std::max(1, count); }
+    const Stats& getStats() const { return stats; }
+
+    // A zero in the board's largest opening, -1 if it has none
+    static int chooseStart(const Board& board) {
+        int gridSize = board.getGridSize();
+        std::vector<int> region(gridSize * gridSize, -1);
+        std::vector<int> pending;
+        int best = -1, bestSize = 0;
+        for (int start = 0; start < gridSize * gridSize; start++) {
+            if (region[start] >= 0 || board.getCellVal(start % gridSize, start / gridSize) != Board::ZERO) continue;
+            int size = 0;
+            region[start] = start;
+            pending.assign(1, start);
+            while (!pending.empty()) {
+                int index = pending.back();
+                pending.pop_back();
+                size++;
+                int x = index % gridSize, y = index / gridSize;
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        int nx = x + dx, ny = y + dy;
+                        if (nx < 0 || nx >= gridSize || ny < 0 || ny >= gridSize) continue;
+                        int neighbor = ny * gridSize + nx;
+                        if (region[neighbor] >= 0 || board.getCellVal(nx, ny) != Board::ZERO) continue;
+                        region[neighbor] = start;
+                        pending.push_back(neighbor);
+                    }
+                }
+            }
+            if (size > bestSize) {
+                bestSize = size;
+                best = start;
+            }
+        }
+        return best;
+    }
+
+    // Plays the board out from `startCell` using only certain moves
+    static Verdict check(const Board& board, int startCell, const std::vector<std::uint64_t>& mineBits) {
+        if (startCell < 0) return NO_OPENING;
+        BoardSnapshot snapshot(board);
+        snapshot.setLayout(mineBits.data());
+        snapshot.reveal(startCell);
+
+        frontierAnalysis analysis;
+        while (snapshot.getGameState() == IBoardSolver::PLAYING) {
+            if (applySimpleRules(snapshot)) continue;
+            if (!analysis.analyze(snapshot, Clock::time_point::max())) return TOO_HARD;
+            if (analysis.getSafeCells().empty()) return NEEDS_GUESS;
+            for (int index : analysis.getSafeCells()) snapshot.reveal(index);
+            for (int index : analysis.getMineCells()) {
+                if (snapshot.isUnknown(index)) snapshot.toggleFlag(index);
+            }
+        }
+        return snapshot.getGameState() == IBoardSolver::WON ? SOLVABLE : NEEDS_GUESS;
+    }
+
+    // Collects the `count` lowest-seeded solvable boards at or after baseSeed (fewer if it gives up)
+    std::vector<boardCorpus::Layout> generate(int gridSize, int mines, std::uint64_t baseSeed, std::uint64_t count) {
+        stats = Stats();
+        const std::uint64_t limit = std::max(MIN_CANDIDATES, count * CANDIDATES_PER_BOARD);
+        auto started = Clock::now();
+        std::atomic<std::uint64_t> nextOffset{0};
+        std::atomic<std::uint64_t> found{0};
+        std::mutex lock;
+        std::map<std::uint64_t, boardCorpus::Layout> accepted;
+
+        auto work = [&]() {
+            Board board(gridSize, mines);
+            std::vector<std::uint64_t> mineBits;
+            Stats local;
+            while (found.load() < count) {
+                std::uint64_t offset = nextOffset.fetch_add(1);
+                if (offset >= limit) break;
+                std::uint64_t seed = baseSeed + offset;
+                board.reset(seed);
+                board.getMineBits(mineBits);
+                int start = chooseStart(board);
+                Verdict verdict = check(board, start, mineBits);
+                local.candidates++;
+                if (verdict == NO_OPENING) local.noOpening++;
+                else if (verdict == NEEDS_GUESS) local.needsGuess++;
+                else if (verdict == TOO_HARD) local.tooHard++;
+                if (verdict != SOLVABLE) continue;
+
+                local.accepted++;
+                std::lock_guard<std::mutex> guard(lock);
+                accepted[seed] = {seed, start, mineBits};
+                found++;
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            stats.candidates += local.candidates;
+            stats.noOpening += local.noOpening;
+            stats.needsGuess += local.needsGuess;
+            stats.tooHard += local.tooHard;
+        };
+
+        // Every seed below the counter has been checked once the workers are joined
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; t++) workers.emplace_back(work);
+        work();
+        for (auto& worker : workers) worker.join();
+
+        std::vector<boardCorpus::Layout> layouts;
+        for (auto& entry : accepted) {
+            if (layouts.size() >= count) break;
+            layouts.push_back(std::move(entry.second));
+        }
+        stats.accepted = layouts.size();
+        stats.gaveUp = layouts.size() < count;
+        stats.seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        return layouts;
+    }
+
+private:
+    // A number whose remaining mines are all placed opens the rest; one that needs every
+    // unknown neighbor flags them. Returns true if anything changed
+    static bool applySimpleRules(BoardSnapshot& snapshot) {
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        int neighbors[8];
+        bool changed = false;
+        for (int index = 0; index < cellCount; index++) {
+            int value = snapshot.get(index);
+            if (value <= 0 || value > 8) continue;
+            int count = snapshot.getNeighbors(index, neighbors);
+            int unknown = 0, flagged = 0;
+            for (int i = 0; i < count; i++) {
+                int neighbor = snapshot.get(neighbors[i]);
+                if (neighbor == BoardSnapshot::UNKNOWN) unknown++;
+                else if (neighbor == BoardSnapshot::FLAGGED) flagged++;
+            }
+            if (unknown == 0) continue;
+            if (flagged == value) {
+                for (int i = 0; i < count; i++) snapshot.reveal(neighbors[i]);
+                changed = true;
+            } else if (flagged + unknown == value) {
+                for (int i = 0; i < count; i++) {
+                    if (snapshot.isUnknown(neighbors[i])) snapshot.toggleFlag(neighbors[i]);
+                }
+                changed = true;
+            }
+        }
+        return changed;
+    }
+};
+
+#endif
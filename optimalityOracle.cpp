@@ -0,0 +1,61 @@
+#ifndef OPTIMALITY_ORACLE_H
+#define OPTIMALITY_ORACLE_H
+
+#include "IBoardSolver.h"
+#include "BoardSnapshot.h"
+#include "frontierAnalysis.cpp"
+#include "constraintSolver.cpp"
+#include <vector>
+#include <chrono>
+
+/**
+ * Every provably safe cell and provable mine of a position, for judging solver moves.
+ *
+ * The exact frontier analysis is complete: a cell is proved safe (or a mine) exactly
+ * when no assignment consistent with the numbers and the global mine count says
+ * otherwise. Components too big for it fall back to the CDCL prover with a large
+ * budget, which is still sound but ignores the mine count, so such positions are
+ * reported as incomplete. Flags are taken as mines, as the solvers take them.
+ */
+class optimalityOracle {
+public:
+    static const int FALLBACK_CONFLICT_BUDGET = 100000; // Per query
+
+private:
+    frontierAnalysis analysis;
+    constraintSolver prover;
+    std::vector<int> safeCells;
+    std::vector<int> mineCells;
+    bool complete = false;
+
+public:
+    optimalityOracle() { prover.setConflictBudget(FALLBACK_CONFLICT_BUDGET); }
+
+    // Proves what can be proved; false if some certain cells may have been missed
+    bool analyze(const IBoardSolver& board) {
+        BoardSnapshot snapshot(board);
+        safeCells.clear();
+        mineCells.clear();
+        complete = analysis.analyze(snapshot, std::chrono::steady_clock::time_point::max());
+        if (complete) {
+            safeCells = analysis.getSafeCells();
+            mineCells = analysis.getMineCells();
+            return true;
+        }
+
+        prover.sync(board);
+        int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+        for (int index = 0; index < cellCount; index++) {
+            if (!snapshot.isUnknown(index)) continue;
+            if (prover.canBe(index, true) == constraintSolver::IMPOSSIBLE) safeCells.push_back(index);
+            else if (prover.canBe(index, false) == constraintSolver::IMPOSSIBLE) mineCells.push_back(index);
+        }
+        return false;
+    }
+
+    bool isComplete() const { return complete; }
+    const std::vector<int>& getSafeCells() const { return safeCells; }
+    const std::vector<int>& getMineCells() const { return mineCells; }
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef PATTERN_TABLE_H
+#define PATTERN_TABLE_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Precomputed deductions for two overlapping numbers (1-2-1, 1-2-2-1, wall 1-1, ...).
+ *
+ * Two numbers A and B within each other's 5x5 window split their unknown neighbors
+ * into three groups: only next to A, shared, only next to B. Whether a whole group
+ * is forced safe or forced mined depends only on the three group sizes and the mines
+ * each number still needs, so a lookup on those five counts replaces the reasoning.
+ * A single number is the case with B's groups empty.
+ *
+ * The table is filled by exhaustive enumeration of the shared group's mine count,
+ * evaluated by the compiler and embedded as constexpr data (no runtime setup).
+ */
+class patternTable {
+public:
+    static const int LIMIT = 9; // Counts run 0..8
+
+    // Result bits per group
+    static const std::uint8_t ONLY_A_SAFE = 1;
+    static const std::uint8_t ONLY_A_MINE = 2;
+    static const std::uint8_t SHARED_SAFE = 4;
+    static const std::uint8_t SHARED_MINE = 8;
+    static const std::uint8_t ONLY_B_SAFE = 16;
+    static const std::uint8_t ONLY_B_MINE = 32;
+    static const std::uint8_t CONTRADICTION = 64; // No assignment fits both numbers
+
+    static constexpr int index(int onlyA, int shared, int onlyB, int needA, int needB) {
+        return (((onlyA * LIMIT + shared) * LIMIT + onlyB) * LIMIT + needA) * LIMIT + needB;
+    }
+
+    static constexpr std::uint8_t lookup(int onlyA, int shared, int onlyB, int needA, int needB) {
+        if (needA < 0 || needB < 0 || needA >= LIMIT || needB >= LIMIT) return CONTRADICTION;
+        return TABLE[index(onlyA, shared, onlyB, needA, needB)];
+    }
+
+private:
+    static constexpr int ENTRIES = LIMIT * LIMIT * LIMIT * LIMIT * LIMIT;
+
+    static constexpr std::uint8_t deduce(int onlyA, int shared, int onlyB, int needA, int needB) {
+        // Which mine counts each group can take over every consistent split
+        bool aCanBeEmpty = false, aCanBeFull = false, aPartial = false;
+        bool sCanBeEmpty = false, sCanBeFull = false, sPartial = false;
+        bool bCanBeEmpty = false, bCanBeFull = false, bPartial = false;
+        bool feasible = false;
+        for (int inShared = 0; inShared <= shared; inShared++) {
+            int inA = needA - inShared;
+            int inB = needB - inShared;
+            if (inA < 0 || inA > onlyA || inB < 0 || inB > onlyB) continue;
+            feasible = true;
+            aCanBeEmpty |= inA == 0;
+            aCanBeFull |= inA == onlyA;
+            aPartial |= inA != 0 && inA != onlyA;
+            sCanBeEmpty |= inShared == 0;
+            sCanBeFull |= inShared == shared;
+            sPartial |= inShared != 0 && inShared != shared;
+            bCanBeEmpty |= inB == 0;
+            bCanBeFull |= inB == onlyB;
+            bPartial |= inB != 0 && inB != onlyB;
+        }
+        if (!feasible) return CONTRADICTION;
+
+        std::uint8_t result = 0;
+        if (onlyA > 0 && !aPartial && aCanBeEmpty != aCanBeFull) result |= aCanBeEmpty ? ONLY_A_SAFE : ONLY_A_MINE;
+        if (shared > 0 && !sPartial && sCanBeEmpty != sCanBeFull) result |= sCanBeEmpty ? SHARED_SAFE : SHARED_MINE;
+        if (onlyB > 0 && !bPartial && bCanBeEmpty != bCanBeFull) result |= bCanBeEmpty ? ONLY_B_SAFE : ONLY_B_MINE;
+        return result;
+    }
+
+    static constexpr std::array<std::uint8_t, ENTRIES> build() {
+        std::array<std::uint8_t, ENTRIES> table{};
+        for (int onlyA = 0; onlyA < LIMIT; onlyA++) {
+            for (int shared = 0; shared < LIMIT; shared++) {
+                for (int onlyB = 0; onlyB < LIMIT; onlyB++) {
+                    for (int needA = 0; needA < LIMIT; needA++) {
+                        for (int needB = 0; needB < LIMIT; needB++) {
+                            table[index(onlyA, shared, onlyB, needA, needB)] = deduce(onlyA, shared, onlyB, needA, needB);
+                        }
+                    }
+                }
+            }
+        }
+        return table;
+    }
+
+    static const std::array<std::uint8_t, ENTRIES> TABLE;
+};
+
+// Defined once the class is complete so build() can run at compile time
+inline constexpr std::array<std::uint8_t, patternTable::ENTRIES> patternTable::TABLE = patternTable::build();
+
+// Known patterns, checked when the table is built
+static_assert(patternTable::lookup(1, 0, 0, 1, 0) == patternTable::ONLY_A_MINE, "a 1 with one unknown neighbor");
+static_assert(patternTable::lookup(3, 0, 0, 0, 0) == patternTable::ONLY_A_SAFE, "a satisfied number");
+static_assert(patternTable::lookup(0, 2, 1, 1, 1) == patternTable::ONLY_B_SAFE, "1-1 along a wall");
+static_assert(patternTable::lookup(1, 2, 1, 1, 2) == (patternTable::ONLY_A_SAFE | patternTable::ONLY_B_MINE), "1-2");
+static_assert(patternTable::lookup(1, 0, 0, 2, 0) == patternTable::CONTRADICTION, "more mines needed than unknowns");
+static_assert(patternTable::lookup(0, 0, 0, 9, 0) == patternTable::CONTRADICTION, "need outside the table");
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef PROBABILITY_ENGINE_H
+#define PROBABILITY_ENGINE_H
+
+#include "BoardSnapshot.h"
+#include "frontierAnalysis.cpp"
+#include "mineSampler.cpp"
+#include <vector>
+#include <chrono>
+
+/**
+ * Per-cell mine probabilities with graceful degradation: exact enumeration
+ * first, and Monte Carlo sampling for whatever budget is left when the exact
+ * engine gives up.
+ */
+class probabilityEngine {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Method { NONE, EXACT, SAMPLED };
+
+private:
+    frontierAnalysis exact;
+    mineSampler sampler;
+    Method method = NONE;
+    std::vector<double> probability;
+
+public:
+    // Exact engine gets `exactShare` of the budget, the sampler the rest
+    Method compute(const BoardSnapshot& snapshot, Clock::time_point deadline, double exactShare = 0.5) {
+        auto now = Clock::now();
+        auto exactDeadline = now + std::chrono::duration_cast<Clock::duration>((deadline - now) * exactShare);
+        method = NONE;
+        if (exact.analyze(snapshot, exactDeadline)) {
+            method = EXACT;
+            int cellCount = snapshot.getGridSize() * snapshot.getGridSize();
+            probability.assign(cellCount, -1.0);
+            for (int index = 0; index < cellCount; index++) {
+                if (snapshot.isUnknown(index)) probability[index] = exact.getMineProbability(index);
+            }
+        } else if (sampler.sample(snapshot, deadline, snapshot.getHash())) {
+            method = SAMPLED;
+            probability = sampler.getProbabilities();
+        }
+        return method;
+    }
+
+    Method getMethod() const { return method; }
+    double getMineProbability(int index) const { return probability[index]; }
+    const std::vector<double>& getProbabilities() const { return probability; }
+    const frontierAnalysis& getExact() const { return exact; }
+    mineSampler& getSampler() { return sampler; }
+
+    // 95% half-width of the estimates; 0 when exact
+    double getHalfWidth() const { return method == SAMPLED ? sampler.getHalfWidth() : 0.0; }
+};
+
+#endif
@@ -1,6 +1,12 @@
 #ifndef SOLVER_UTILITIES_H
 #define SOLVER_UTILITIES_H
 
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <utility>
+
 class solverUtilities {
 public:
 
@@ -10,7 +16,27 @@ public:
     }
 
     static int getRandomInt(int min, int max) {
-        return rand() % (max - min + 1) + min;
+        return std::uniform_int_distribution<int>(min, max)(generator());
+    }
+
+    // Every random move comes from this thread's generator, so worker threads don't share
+    // (or race on) one sequence and a run can restart the sequence per game
+    static std::mt19937_64& generator() {
+        thread_local std::mt19937_64 rng;
+        return rng;
+    }
+
+    static void seed(std::uint64_t value) {
+        generator().seed(value);
+    }
+
+    // Moves the deadline one delay past the previous one so moves keep a steady cadence;
+    // falls back to "now" if the solver was idle and the deadline is stale
+    static void scheduleAfter(std::chrono::steady_clock::time_point& deadline, float seconds) {
+        auto now = std::chrono::steady_clock::now();
+        auto delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(seconds));
+        auto base = (now - deadline < delay) ? deadline : now;
+        deadline = base + delay;
     }
 
 };
@@ -0,0 +1,232 @@
+#ifndef TRANSFER_MATRIX_H
+#define TRANSFER_MATRIX_H
+
+#include "BoardSnapshot.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * Exact solution counting for long, thin frontier components.
+ *
+ * Cells are swept in a low-bandwidth (Cuthill-McKee) order. At each step only the
+ * numbers that have started but not finished matter, so the state is their partial
+ * mine counts (4 bits each, packed into one key) and every state carries counts
+ * indexed by mines placed so far. A forward and a backward sweep are joined at each
+ * cell to get per-cell counts, so the cost grows linearly with the component's
+ * length and exponentially only with its width.
+ */
+class transferMatrix {
+public:
+    static const int MAX_ACTIVE = 15; // Open numbers at any step (4-bit slots in a 64-bit key)
+    static const size_t MAX_STATES = 1 << 16; // Per step; wider components go to another engine
+
+    struct Counts {
+        std::vector<double> byMines;                  // Solutions with k mines
+        std::vector<std::vector<double>> cellByMines; // Per component cell: solutions with it a mine and k mines
+    };
+
+private:
+    using Table = std::unordered_map<std::uint64_t, std::vector<double>>;
+
+    struct Constraint {
+        int need = 0;
+        std::vector<int> positions; // Sweep positions of its cells, ascending
+    };
+
+    // How one number is carried across a step
+    struct Carry {
+        int constraint;
+        int fromSlot;     // Slot on the near side of the step, -1 if not open there
+        int toSlot;       // Slot on the far side, -1 if it closes (forward) / opens (backward) here
+        bool contains;    // The swept cell is one of its cells
+        int remaining;    // Forward only: its cells after this step
+    };
+
+    static int getSlot(std::uint64_t key, int slot) { return static_cast<int>((key >> (slot * 4)) & 15); }
+    static std::uint64_t withSlot(std::uint64_t key, int slot, int value) { return key | (static_cast<std::uint64_t>(value) << (slot * 4)); }
+
+    static void addShifted(std::vector<double>& into, const std::vector<double>& from, int shift) {
+        if (into.size() < from.size() + shift) into.resize(from.size() + shift, 0.0);
+        for (size_t k = 0; k < from.size(); k++) into[k + shift] += from[k];
+    }
+
+public:
+    // False if the component is too wide for the sweep (caller should use another engine)
+    static bool count(const BoardSnapshot& snapshot, const BoardSnapshot::FrontierComponent& part, Counts& counts) {
+        const std::vector<int>& cells = part.unknowns;
+        int size = static_cast<int>(cells.size());
+        counts.byMines.clear();
+        counts.cellByMines.assign(size, {});
+
+        // Numbers as constraints over component cells
+        std::vector<Constraint> constraints;
+        std::vector<std::vector<int>> cellConstraints(size);
+        int neighbors[8];
+        for (int number : part.numbers) {
+            Constraint constraint;
+            constraint.need = snapshot.get(number);
+            int count = snapshot.getNeighbors(number, neighbors);
+            for (int i = 0; i < count; i++) {
+                int value = snapshot.get(neighbors[i]);
+                if (value == BoardSnapshot::FLAGGED) constraint.need--;
+                if (value != BoardSnapshot::UNKNOWN) continue;
+                int cell = static_cast<int>(std::lower_bound(cells.begin(), cells.end(), neighbors[i]) - cells.begin());
+                cellConstraints[cell].push_back(static_cast<int>(constraints.size()));
+                constraint.positions.push_back(cell); // Cell ids for now, positions after ordering
+            }
+            if (constraint.need < 0 || constraint.need > static_cast<int>(constraint.positions.size())) return true; // No solutions
+            constraints.push_back(std::move(constraint));
+        }
+
+        std::vector<int> order = sweepOrder(size, constraints, cellConstraints);
+        std::vector<int> position(size);
+        for (int t = 0; t < size; t++) position[order[t]] = t;
+        for (Constraint& constraint : constraints) {
+            for (int& entry : constraint.positions) entry = position[entry];
+            std::sort(constraint.positions.begin(), constraint.positions.end());
+        }
+
+        // Numbers open at each boundary t (between cells t-1 and t)
+        std::vector<std::vector<int>> open(size + 1);
+        for (int c = 0; c < static_cast<int>(constraints.size()); c++) {
+            for (int t = constraints[c].positions.front() + 1; t <= constraints[c].positions.back(); t++) open[t].push_back(c);
+        }
+        for (const auto& list : open) {
+            if (static_cast<int>(list.size()) > MAX_ACTIVE) return false;
+        }
+
+        // Per step, how every number touching the boundary on either side is carried
+        std::vector<std::vector<Carry>> steps(size);
+        for (int t = 0; t < size; t++) {
+            std::vector<int> touched = open[t];
+            touched.insert(touched.end(), open[t + 1].begin(), open[t + 1].end());
+            for (int c : cellConstraints[order[t]]) touched.push_back(c);
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            for (int c : touched) {
+                const Constraint& constraint = constraints[c];
+                Carry carry;
+                carry.constraint = c;
+                carry.fromSlot = slotOf(open[t], c);
+                carry.toSlot = slotOf(open[t + 1], c);
+                carry.contains = std::binary_search(constraint.positions.begin(), constraint.positions.end(), t);
+                carry.remaining = static_cast<int>(constraint.positions.end() - std::upper_bound(constraint.positions.begin(), constraint.positions.end(), t));
+                steps[t].push_back(carry);
+            }
+        }
+
+        // Forward: counts of prefix assignments by open-number state
+        std::vector<Table> forward(size + 1);
+        forward[0][0] = {1.0};
+        for (int t = 0; t < size; t++) {
+            for (const auto& [key, byMines] : forward[t]) {
+                for (int mine = 0; mine <= 1; mine++) {
+                    std::uint64_t next = 0;
+                    bool feasible = true;
+                    for (const Carry& carry : steps[t]) {
+                        int need = constraints[carry.constraint].need;
+                        int placed = (carry.fromSlot >= 0 ? getSlot(key, carry.fromSlot) : 0) + (carry.contains ? mine : 0);
+                        if (placed > need || placed + carry.remaining < need) {
+                            feasible = false;
+                            break;
+                        }
+                        if (carry.toSlot >= 0) next = withSlot(next, carry.toSlot, placed);
+                    }
+                    if (feasible) addShifted(forward[t + 1][next], byMines, mine);
+                }
+            }
+            if (forward[t + 1].size() > MAX_STATES) return false;
+        }
+        auto complete = forward[size].find(0);
+        if (complete == forward[size].end()) return true; // No solutions
+        counts.byMines = complete->second;
+
+        // Backward: counts of suffix assignments by the mines they put on each open number
+        std::vector<Table> backward(size + 1);
+        backward[size][0] = {1.0};
+        for (int t = size - 1; t >= 0; t--) {
+            for (const auto& [key, byMines] : backward[t + 1]) {
+                for (int mine = 0; mine <= 1; mine++) {
+                    std::uint64_t previous = 0;
+                    bool feasible = true;
+                    for (const Carry& carry : steps[t]) {
+                        int need = constraints[carry.constraint].need;
+                        int placed = (carry.toSlot >= 0 ? getSlot(key, carry.toSlot) : 0) + (carry.contains ? mine : 0);
+                        if (placed > need || (carry.fromSlot < 0 && placed != need)) {
+                            feasible = false;
+                            break;
+                        }
+                        if (carry.fromSlot >= 0) previous = withSlot(previous, carry.fromSlot, placed);
+                    }
+                    if (feasible) addShifted(backward[t][previous], byMines, mine);
+                }
+            }
+        }
+
+        // Join prefix and suffix around each cell set to a mine
+        for (int t = 0; t < size; t++) {
+            std::vector<double>& result = counts.cellByMines[order[t]];
+            for (const auto& [key, prefix] : forward[t]) {
+                std::uint64_t wanted = 0;
+                bool feasible = true;
+                for (const Carry& carry : steps[t]) {
+                    int need = constraints[carry.constraint].need;
+                    int placed = (carry.fromSlot >= 0 ? getSlot(key, carry.fromSlot) : 0) + (carry.contains ? 1 : 0);
+                    if (placed > need || (carry.toSlot < 0 && placed != need)) {
+                        feasible = false;
+                        break;
+                    }
+                    if (carry.toSlot >= 0) wanted = withSlot(wanted, carry.toSlot, need - placed);
+                }
+                if (!feasible) continue;
+                auto suffix = backward[t + 1].find(wanted);
+                if (suffix == backward[t + 1].end()) continue;
+                if (result.size() < prefix.size() + suffix->second.size()) result.resize(prefix.size() + suffix->second.size(), 0.0);
+                for (size_t a = 0; a < prefix.size(); a++) {
+                    if (prefix[a] == 0.0) continue;
+                    for (size_t b = 0; b < suffix->second.size(); b++) result[a + b + 1] += prefix[a] * suffix->second[b];
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    static int slotOf(const std::vector<int>& list, int constraint) {
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list[i] == constraint) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Breadth-first order from a far end of the component keeps numbers open for few steps
+    static std::vector<int> sweepOrder(int size, const std::vector<Constraint>& constraints, const std::vector<std::vector<int>>& cellConstraints) {
+        auto bfs = [&](int start) {
+            std::vector<int> order;
+            std::vector<bool> seen(size, false);
+            seen[start] = true;
+            order.push_back(start);
+            for (size_t head = 0; head < order.size(); head++) {
+                for (int c : cellConstraints[order[head]]) {
+                    for (int cell : constraints[c].positions) {
+                        if (seen[cell]) continue;
+                        seen[cell] = true;
+                        order.push_back(cell);
+                    }
+                }
+            }
+            // Components are connected through numbers, but be safe
+            for (int cell = 0; cell < size; cell++) {
+                if (!seen[cell]) order.push_back(cell);
+            }
+            return order;
+        };
+        // The last cell reached from anywhere is near one end; sweep from there
+        std::vector<int> first = bfs(0);
+        return bfs(first.back());
+    }
+};
+
+#endif
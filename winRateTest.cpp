@@ -0,0 +1,81 @@
+#ifndef WIN_RATE_TEST_H
+#define WIN_RATE_TEST_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Confidence intervals and stopping rules for win rates measured while games run.
+ *
+ * A single win rate uses the Wilson score interval, which stays honest near 0% and
+ * 100% and for small samples. Two solvers played on the same boards are compared
+ * through their paired outcomes: only boards where exactly one of them won carry
+ * information, and under "no difference" each such board favours either side with
+ * probability 1/2. The sequential test is a mixture likelihood ratio over those
+ * boards (uniform prior on the true split): by Ville's inequality it crosses 1/alpha
+ * with probability at most alpha under no difference, however often it is checked,
+ * so a run may stop the moment it crosses.
+ */
+class winRateTest {
+public:
+    static constexpr double Z95 = 1.959963984540054;
+
+    struct Interval {
+        double centre = 0.0;
+        double halfWidth = 1.0;
+    };
+
+    // 95% Wilson score interval for `wins` out of `games`
+    static Interval wilson(std::uint64_t wins, std::uint64_t games) {
+        Interval interval;
+        if (games == 0) return interval;
+        double n = static_cast<double>(games);
+        double p = wins / n;
+        double z2 = Z95 * Z95;
+        double denominator = 1.0 + z2 / n;
+        interval.centre = (p + z2 / (2.0 * n)) / denominator;
+        interval.halfWidth = Z95 * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denominator;
+        return interval;
+    }
+
+    // Outcomes of solvers A and B on the same boards
+    struct Paired {
+        std::uint64_t both = 0;
+        std::uint64_t onlyA = 0;
+        std::uint64_t onlyB = 0;
+        std::uint64_t neither = 0;
+
+        void add(bool wonA, bool wonB) {
+            if (wonA && wonB) both++;
+            else if (wonA) onlyA++;
+            else if (wonB) onlyB++;
+            else neither++;
+        }
+
+        std::uint64_t games() const { return both + onlyA + onlyB + neither; }
+
+        // Win rate of A minus win rate of B, 95% normal interval on the paired differences
+        Interval difference() const {
+            Interval interval;
+            std::uint64_t n = games();
+            if (n == 0) return interval;
+            double d = (static_cast<double>(onlyA) - static_cast<double>(onlyB)) / n;
+            double variance = ((onlyA + onlyB) / static_cast<double>(n) - d * d) / n;
+            interval.centre = d;
+            interval.halfWidth = Z95 * std::sqrt(std::max(0.0, variance));
+            return interval;
+        }
+
+        // Log of the mixture likelihood ratio against "A and B are equally good"
+        double logLikelihoodRatio() const {
+            double a = static_cast<double>(onlyA), b = static_cast<double>(onlyB);
+            return std::lgamma(a + 1.0) + std::lgamma(b + 1.0) - std::lgamma(a + b + 2.0) + (a + b) * std::log(2.0);
+        }
+
+        // True once the difference is significant at `alpha`; the sign of onlyA - onlyB says who is better
+        bool significant(double alpha) const { return logLikelihoodRatio() >= std::log(1.0 / alpha); }
+    };
+};
+
+#endif
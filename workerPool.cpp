@@ -0,0 +1,82 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Helper threads started once and reused for every parallel step, so a search
+ * that fans out on each move doesn't create and join OS threads each time.
+ * run() hands job(1..active-1) to the helpers, runs job(0) on the caller and
+ * returns once all of them are done.
+ */
+class workerPool {
+private:
+    std::vector<std::thread> helpers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::function<void(int)> job;
+    std::uint64_t generation = 0;
+    int active = 0;
+    int pending = 0;
+    bool stopping = false;
+
+public:
+    explicit workerPool(int helperCount) {
+        for (int i = 1; i <= helperCount; i++) helpers.emplace_back([this, i]() { loop(i); });
+    }
+
+    ~workerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& helper : helpers) helper.join();
+    }
+
+    workerPool(const workerPool&) = delete;
+    workerPool& operator=(const workerPool&) = delete;
+
+    int getThreads() const { return static_cast<int>(helpers.size()) + 1; }
+
+    // Runs work(0..count-1) with count clamped to 1..getThreads()
+    void run(int count, const std::function<void(int)>& work) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = work;
+            active = std::max(1, std::min(count, getThreads()));
+            pending = active - 1;
+            generation++;
+        }
+        if (active > 1) wake.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return pending == 0; });
+    }
+
+private:
+    void loop(int index) {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (index >= active) continue;
+            std::function<void(int)> work = job;
+            lock.unlock();
+            work(index);
+            lock.lock();
+            if (--pending == 0) finished.notify_one();
+        }
+    }
+};
+
+#endif